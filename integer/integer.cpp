@@ -6,6 +6,9 @@
 #include <assert.h>
 #include <functional>  // std::plus
 #include <numeric>     // inner_product
+#include <algorithm>   // std::fill, std::copy, std::min
+#include <stdexcept>   // std::length_error
+#include <cstdlib>     // std::abs
 
 using vec32 = std::vector < uint32_t >;
 using Uint128 = std::pair<uint64_t, uint64_t>;  // least and most significant 64 bits
@@ -139,10 +142,20 @@ namespace Big_numbers {
       else
       {
         n.push_back(carry);  // carry goes into a new word
+        carry = 0u;
       }
     }
   }
 
+  // erase MS zeros, to restore the vec32 invariant
+  static void remove_MSW_zeros(vec32& v) noexcept
+  {
+    while ((v.size() != 0) && (v.back() == 0))
+    {
+      v.pop_back();
+    }
+  }
+
   std::pair< std::vector<uint32_t>, bool> symdiff_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
   {
     std::pair< std::vector<uint32_t>, bool> result;
@@ -153,6 +166,7 @@ namespace Big_numbers {
     {
       result.first.reserve(asize);
       arithmetic_algorithm::subtract_unsafe(a.begin(), a.end(), b.begin(), b.end(), result.first);
+      remove_MSW_zeros(result.first);
       return result;
     }
     if (asize < bsize)
@@ -160,6 +174,7 @@ namespace Big_numbers {
       result.second = false;
       result.first.reserve(bsize);
       arithmetic_algorithm::subtract_unsafe(b.begin(), b.end(), a.begin(), a.end(), result.first);
+      remove_MSW_zeros(result.first);
       return result;
     }
 
@@ -193,6 +208,7 @@ namespace Big_numbers {
       result.second = false;
       arithmetic_algorithm::subtract_unsafe(b.begin(), rbiter.base(), a.begin(), raiter.base(), result.first);
     }
+    remove_MSW_zeros(result.first);
     return result;
   }
 
@@ -213,6 +229,7 @@ namespace Big_numbers {
       else
       {
         n.push_back(carry);  // carry goes into a new word
+        carry = 0u;
       }
     }
   }
@@ -279,8 +296,12 @@ namespace Big_numbers {
     size_t i(0u);
     for (; i < a.size(); ++i)
     {
-      uint32_t s(carry + a[i] + b[i]); // this could wrap, test on next line for wrap
-      carry = (s < a[i]) || (s < b[i]); // detect rollover
+      // two adds, each could wrap.  Testing once for the sum of all three would
+      // miss the rollover of 0xffffffff + 0xffffffff + 1.
+      const uint32_t s1(a[i] + carry);
+      carry = (s1 < carry);  // detect rollover
+      const uint32_t s(s1 + b[i]);
+      carry += (s < s1);     // detect rollover, at most one of the two adds can wrap
       result.push_back(s);
     }
 
@@ -549,7 +570,7 @@ namespace Big_numbers {
     const size_t b_size = b.num.d.size();
 
     vec32 result = (a_size < b_size) ? add_ordered(a.num.d, b.num.d) : add_ordered(b.num.d, a.num.d);
-    return Nat(result);
+    return Nat(std::move(result));
 
   }  // end add()
 
@@ -638,27 +659,24 @@ namespace Big_numbers {
       accum += (prod & LSW);
 
       // accum has word to subtract from index=(index_of_work + i)
-      //size_t index = index_of_work + i;
-      const uint32_t adjust = accum + borrow;
-      //if (adjust)
+      // adjust is 64 bits, since accum + borrow can be 2**32
+      const uint64_t adjust = uint64_t(accum) + borrow;
       {
         const uint32_t prev = r[index];
-        const uint32_t newv = prev - adjust;
-        borrow = (newv >= prev);  // check for underflow
-        r[index] = newv;
+        r[index] = prev - uint32_t(adjust);
+        borrow = (prev < adjust);  // check for underflow
       }
 
       accum = (accum < prev) + uint32_t(prod >> 32u);  // add in carry and product terms
     }
 
     // if overflow, there might be one more accum word to subtract
-    const uint32_t adjust = accum + borrow;
+    const uint64_t adjust = uint64_t(accum) + borrow;
     if (adjust)
     {
       const uint32_t prev = r[index];
-      const uint32_t newv = prev - adjust;
-      borrow = (newv >= prev);  // check for underflow
-      r[index] = newv;
+      r[index] = prev - uint32_t(adjust);
+      borrow = (prev < adjust);  // check for underflow
       ++index;
     }
 
@@ -858,10 +876,6 @@ namespace Big_numbers {
       accum = shr_32(temp);
     }
 
-#ifdef _DEBUG
-    assert((0 == result.size()) || (result.back() != 0));  // unless n is zero, the MSW is nonzero 
-#endif
-
                                  // the position of the most signifcant word isn't known until now
                                  // for example 11*11 = 0121, don't want to push that 0, just 3 digit result
                                  // but         99*99 = 9801, do want to push that last digit, a 4 digit result
@@ -877,470 +891,4186 @@ namespace Big_numbers {
     return result;
   }  // end mul_ordered
 
-  std::vector<uint32_t> mul_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+  // Fixed-length kernels on raw words, used by the divide-and-conquer multiplies.
+  // Unlike the vec32 functions above, the ranges may have MSW zeros,
+  // and a result is always written to a full-length output range.
+
+  // r[0..n) = a[0..n) + b[0..n), returns the carry out of the MSW
+  static uint32_t add_n(uint32_t* r, const uint32_t* a, const uint32_t* b, const size_t n) noexcept
   {
-    return a.size() < b.size()
-      ? mul_ordered(a, b)
-      : mul_ordered(b, a);
+    uint32_t carry(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint32_t s = a[i] + carry;
+      carry = (s < carry);
+      r[i] = s + b[i];
+      carry += (r[i] < s);
+    }
+    return carry;
   }
 
-#if 0
-  vec32 mul_Karatsuba(const vec32& a, const vec32& b)
+  // r[0..n) = a[0..n) - b[0..n), returns the borrow out of the MSW
+  static uint32_t sub_n(uint32_t* r, const uint32_t* a, const uint32_t* b, const size_t n) noexcept
   {
-    // TODO make a version that uses vec32::const_iterator and vec32::const_iterator
-    // When this works, turn into a template
-#ifdef _DEBUG
-    assert(a.size() <= b.size());
-    assert(b.size() <= a.size() + 1u);
-#endif
+    uint32_t borrow(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint32_t bb = b[i] + borrow;
+      borrow = (bb < borrow);
+      const uint32_t ai = a[i];
+      r[i] = ai - bb;
+      borrow += (r[i] > ai);
+    }
+    return borrow;
+  }
 
-    // TBD write Karatsuba algorithm
-    // A = a0  + a1 << N    (this is a word shift)
-    // B = b0  + b1 << M
-    // A*B = a0*b0   
-    //     + (a0 * b1)<<M + (a1*b0)<<N
-    //     + a1*b1 << (N+M)      
-    // choose N=M
-    //     = t0 + t1<<N + t2 <<2N
-    //where 
-    //   t0 = a0*b0
-    //   t1 = a0*b1+a1*b0 = t0+t2-(a0-a1)*(b0-b1) 
-    //   t2 = a1*b1
-    //
-    // So can use only 3 recursive multiplies (vs 4 normally)
-    //
-    // memory layout for result, do in-place
-    //         N words  N words  N words N words
-    // step 1  (a0-a1)                   (b0-b1)
-    // step 2  (a0-a1) (a0-a1)*(b0-b1)   0
-    // step 3  t0L     +=t0L             0
-    // step 4          +=t0U    +=t0U    0+
-    // step 5          +=t2L    +=t2L    0+
-    // step 6                   +=t2U    +=t2U
-    // 
-    //
-    // 1.  allocate space for result (4N, assuming 2N = A.size())
-    // 2.  figure the signs of a0-a1 and b0-b1
-    //     store abs(a0-a1) in left N words of result, 
-    //     store abs(b0-b1) in right N words of result (position 3N of result).
-    // 3.  store abs(a0-a1)*abs(b0-b1) starting at Nth word of result
-    //     use a recursive call to do the multiply
-    // 4.  calcuate t0 lazily. Store the first N words of t0 in the first N words
-    //     of the result, and also accumulate into the second N of the result.
-    //     Accumulate the second N words of t0 into the second and third N
-    //     words of the result.
-    // 5.  calculate t2 lazily.  Accumulate first N words of t2 into the second and
-    //     third N words of result.  Accumlate the last N words of t2 into the third
-    //     N words of result, and assign to last N words of result (doing carrys as needed).
-    // 
-    //     This algorithm assumes the existence of a Karatsuba generator for t0 and t2.
-    //     this means the multiply in step 3 is done by a generator,
-    //     which is used in steps 4 and 5 for the accumulation.
-    //     So, basically you have to be able to do a Karatsuba generator 
-    //     in order to do an in-place non-generator multiply.
-    return mul_ordered(a, b);
+  // r[0..rn) += a[0..an), where an <= rn. Returns the carry out of r[rn-1].
+  static uint32_t add_in_place(uint32_t* r, const size_t rn, const uint32_t* a, const size_t an) noexcept
+  {
+    uint32_t carry = add_n(r, r, a, an);
+    for (size_t i(an); (i < rn) && (carry != 0u); ++i)
+    {
+      ++r[i];
+      carry = (r[i] == 0u);
+    }
+    return carry;
   }
-#endif
 
-  bool loop_invariant(const vec32& numerator, const uint32_t divisor, const vec32& quotient, const uint32_t remainder)
+  // r[0..rn) -= a[0..an), where an <= rn. Returns the borrow out of r[rn-1].
+  static uint32_t sub_in_place(uint32_t* r, const size_t rn, const uint32_t* a, const size_t an) noexcept
   {
-    // predicate to assert numerator = quotient*divisor + remainder
-    // Allows quotient to be de-normalized (can have MSW zero).
+    uint32_t borrow = sub_n(r, r, a, an);
+    for (size_t i(an); (i < rn) && (borrow != 0u); ++i)
+    {
+      borrow = (r[i] == 0u);
+      --r[i];
+    }
+    return borrow;
+  }
 
-    // first, make a normalized version of the quotient.
-    vec32 q = quotient;
-    // remove any 0 MSWs left in the quotient
-    while ((q.size() != 0) && (q.back() == 0))
+  // r[0..n) = -a[0..n) mod 2**(32*n).  r may be the same as a.
+  static void neg_n(uint32_t* r, const uint32_t* a, const size_t n) noexcept
+  {
+    uint32_t borrow(0u);
+    for (size_t i(0); i < n; ++i)
     {
-      q.pop_back();
+      const uint32_t ai = a[i];
+      r[i] = 0u - ai - borrow;
+      borrow |= (ai != 0u);
     }
-    vec32 prod = mul_vec32_by_word(q, divisor);
+  }
 
-    vec32 sum = add_vec32_and_word(prod, remainder);
-    const bool return_val(sum == numerator);
-    return return_val;
+  // r[0..n) = a[0..n) * w, returns the MSW of the product, r[n].
+  static uint32_t mul_1(uint32_t* r, const uint32_t* a, const size_t n, const uint32_t w) noexcept
+  {
+    const uint64_t ww(w);
+    uint64_t carry(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint64_t t = uint64_t(a[i]) * ww + carry;
+      r[i] = uint32_t(t);
+      carry = (t >> 32u);
+    }
+    return uint32_t(carry);
   }
 
+  // r[0..n) += a[0..n) * w, returns the word carried out of r[n-1].
+  // (2**32-1)**2 + 2*(2**32-1) = 2**64-1, so one 64-bit accumulator is enough.
+  static uint32_t addmul_1(uint32_t* r, const uint32_t* a, const size_t n, const uint32_t w) noexcept
+  {
+    const uint64_t ww(w);
+    uint64_t carry(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint64_t t = uint64_t(a[i]) * ww + r[i] + carry;
+      r[i] = uint32_t(t);
+      carry = (t >> 32u);
+    }
+    return uint32_t(carry);
+  }
 
-  bool loop_invariant(const vec32& numerator, const vec32& divisor, const vec32& quotient, const vec32& remainder)
+  // r[0..an+bn) = a[0..an) * b[0..bn), the elementary-school multiply.
+  // precondition: an != 0, bn != 0, and r does not overlap a or b.
+  static void mul_basecase(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn) noexcept
   {
-    // predicate to assert numerator = quotient*divisor + remainder
-    // Allows quotient to be de-normalized (can have MSW zero).
+    r[bn] = mul_1(r, b, bn, a[0]);
+    for (size_t i(1); i < an; ++i)
+    {
+      r[i + bn] = addmul_1(r + i, b, bn, a[i]);
+    }
+  }
 
-    // first, make a normalized version of the quotient.
-    vec32 q = quotient;
-    // remove any 0 MSWs left in the quotient
-    while ((q.size() != 0) && (q.back() == 0))
+  // r[0..n) = abs(a[0..n) - b[0..bn)), where bn <= n.
+  // Returns true if a < b, that is, if the difference is negative.
+  static bool abs_diff_n(uint32_t* r, const uint32_t* a, const size_t n, const uint32_t* b, const size_t bn) noexcept
+  {
+    // scan from the MSW to find which is larger
+    size_t i(n);
+    bool a_is_less(false);
+    while (i != 0u)
     {
-      q.pop_back();
+      --i;
+      const uint32_t bval = (i < bn) ? b[i] : 0u;
+      if (a[i] != bval)
+      {
+        a_is_less = (a[i] < bval);
+        break;
+      }
     }
-    vec32 prod = mul_vec32(q, divisor);
 
-    const size_t r_size = remainder.size();
-    const size_t p_size = prod.size();
+    if (a_is_less)
+    {
+      // b-a, the words of a above bn are zero (else a would be larger)
+      sub_n(r, b, a, bn);
+      std::fill(r + bn, r + n, 0u);
+    }
+    else
+    {
+      uint32_t borrow = sub_n(r, a, b, bn);
+      for (size_t j(bn); j < n; ++j)
+      {
+        r[j] = a[j] - borrow;
+        borrow = (borrow != 0u) && (a[j] == 0u);
+      }
+    }
+    return a_is_less;
+  }
 
-    vec32 sum = add_vec32(prod, remainder);
-    const bool return_val(sum == numerator);
-    return return_val;
+  std::pair<vec32, uint32_t> div(const vec32& n, const uint32_t d);
+  std::pair<vec32, uint32_t> div(const vec32& n, const Word_divisor& d);
+  static void mul_Karatsuba_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn, uint32_t* scratch);
+  static void mul_Toom3_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn);
+  static void mul_Toom4_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn);
+  static void mul_NTT_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn);
+  static void sqr_dispatch(uint32_t* r, const uint32_t* a, const size_t n, uint32_t* scratch);
+  static void mul_unbalanced_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn, uint32_t* scratch);
+
+  // The NTT primes allow transforms of up to 2**25 16-bit pieces,
+  // so the product can have at most 2**24 words.
+  static const size_t NTT_MAX_WORDS = size_t(1u) << 24u;
+
+  static bool use_NTT(const size_t an, const size_t bn) noexcept
+  {
+    return (an >= NTT_THRESHOLD) && (an + bn <= NTT_MAX_WORDS);
   }
 
-  // div, divide n by d, returning a quotient and a remainder
-  // satisfies n = quot * d + rem,   where rem < d, unless d==0, in which case rem=d=0
-  std::pair<vec32, uint32_t> div(const vec32& n, const uint32_t d)
+  // The Toom-k multiplies split the longer operand into k pieces, so the
+  // shorter one needs to have about k-1 pieces for the split to pay off.
+  static bool use_Toom4(const size_t an, const size_t bn) noexcept
   {
-    // allocate memory for the returned quotient, zero filling it.
-    // It might be 1 word too large and may need a pop_back to preserve the invariant (quotient.back() != 0u)
-    std::pair<vec32, uint32_t> quot_rem;
+    return (an >= TOOM4_THRESHOLD) && (4u * an >= 3u * bn);
+  }
 
-    vec32& ret_quotient = quot_rem.first;
-    uint32_t& ret_remainder = quot_rem.second;
+  static bool use_Toom3(const size_t an, const size_t bn) noexcept
+  {
+    return (an >= TOOM3_THRESHOLD) && (3u * an >= 2u * bn);
+  }
 
-    ret_remainder = 0u;
+  // r[0..an+bn) = a[0..an) * b[0..bn), choosing the algorithm by size.
+  // precondition: 0 < an <= bn, and r does not overlap a, b or scratch.
+  // scratch must have room for karatsuba_scratch_size(min(bn, 2*an)) words.
+  static void mul_dispatch(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn, uint32_t* scratch)
+  {
+#ifdef _DEBUG
+    assert((0u < an) && (an <= bn));
+#endif
+    if ((a == b) && (an == bn))
+    {
+      sqr_dispatch(r, a, an, scratch);
+    }
+    else if (an <= KARATSUBA_THRESHOLD)
+    {
+      mul_basecase(r, a, an, b, bn);
+    }
+    else if (2u * an < bn)
+    {
+      mul_unbalanced_n(r, a, an, b, bn, scratch);
+    }
+    else if (use_NTT(an, bn))
+    {
+      mul_NTT_n(r, a, an, b, bn);
+    }
+    else if (use_Toom4(an, bn))
+    {
+      mul_Toom4_n(r, a, an, b, bn);
+    }
+    else if (use_Toom3(an, bn))
+    {
+      mul_Toom3_n(r, a, an, b, bn);
+    }
+    else
+    {
+      mul_Karatsuba_n(r, a, an, b, bn, scratch);
+    }
+  }
 
-    if (test_zero(n))
+  // Number of words of scratch needed to multiply (or square) operands of size at most n.
+  static size_t karatsuba_scratch_size(size_t n) noexcept
+  {
+    // each Karatsuba level splits in half and keeps 4*half+1 words.
+    size_t words(0u);
+    while (n > std::min(KARATSUBA_THRESHOLD, SQR_KARATSUBA_THRESHOLD))
     {
+      const size_t half = n - n / 2u;
+      words += 4u * half + 1u;
+      n = half;
+    }
+    return words;
+  }
+
+  // Karatsuba multiply,  r[0..an+bn) = a[0..an) * b[0..bn)
+  // precondition:  0 < an <= bn <= 2*an
+  //
+  // Split at half = ceil(bn/2) words, so
+  //   A = a0 + a1 << half     (this is a word shift)
+  //   B = b0 + b1 << half
+  //   A*B = t0 + t1 << half + t2 << 2*half
+  // where
+  //   t0 = a0*b0
+  //   t1 = a0*b1+a1*b0 = t0+t2-(a0-a1)*(b0-b1)
+  //   t2 = a1*b1
+  // So only 3 recursive multiplies are needed (vs 4 normally).
+  //
+  // memory layout:
+  //   r        t0 in words [0, 2*half), t2 in words [2*half, an+bn)
+  //   scratch  (a0-a1)*(b0-b1) in words [0, 2*half),
+  //            abs(a0-a1) and abs(b0-b1) in words [2*half, 4*half), later overwritten by t0+t2
+  //            the recursive calls use the scratch after word 4*half+1
+  static void mul_Karatsuba_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn, uint32_t* scratch)
+  {
 #ifdef _DEBUG
-      assert(loop_invariant(n, d, quot_rem.first, quot_rem.second));
+    assert((0u < an) && (an <= bn) && (bn <= 2u * an));
 #endif
-      return quot_rem;
+    const size_t half = bn - bn / 2u;
+    const size_t a1n = an - half;   // a1n <= b1n <= half
+    const size_t b1n = bn - half;
+    const size_t rn = an + bn;
+
+    uint32_t* const prod_diff = scratch;
+    uint32_t* const adiff = scratch + 2u * half;
+    uint32_t* const bdiff = adiff + half;
+    uint32_t* const next_scratch = scratch + 4u * half + 1u;
+
+    const bool adiff_negative = abs_diff_n(adiff, a, half, a + half, a1n);
+    const bool bdiff_negative = abs_diff_n(bdiff, b, half, b + half, b1n);
+
+    mul_dispatch(prod_diff, adiff, half, bdiff, half, next_scratch);
+    mul_dispatch(r, a, half, b, half, next_scratch);   // t0
+    if (a1n == 0u)
+    {
+      std::fill(r + 2u * half, r + rn, 0u);  // t2 = 0
     }
-
-    if (0u != d)
+    else
     {
-      ret_quotient = vec32(n.size(), 0u);  // allocate enough space for the quotient, 0 initialize.
-      vec32 remainder = n;   // copy the numerator
+      mul_dispatch(r + 2u * half, a + half, a1n, b + half, b1n, next_scratch);  // t2
+    }
 
-                   // at this point, have established the invariant
-                   // n = quotient*d + remainder; 
-                   // underestimate the quotient and keep subtracting until remainder < d
-      size_t rsize = remainder.size();
-      while (rsize > 1)
-      {
-        // whittle down the size of the remainder while preserving invariant
-        // divide the high two words of the invariant by the divisor word
-        // This will result in 1 or 2 words of quotient.
-        const size_t rsizem1(rsize - 1u);
-        const size_t rsizem2 = (rsizem1 - 1u);
-        const uint64_t high_words = (uint64_t(remainder[rsizem1]) << 32) + uint64_t(remainder[rsizem2]);
+    // t1 = t0 + t2 -+ (a0-a1)*(b0-b1), uses 2*half+1 words
+    uint32_t* const t1 = adiff;  // a0-a1 and b0-b1 no longer needed
+    const size_t t2n = rn - 2u * half;
+    std::copy(r, r + 2u * half, t1);
+    t1[2u * half] = add_in_place(t1, 2u * half, r + 2u * half, t2n);
+    if (adiff_negative == bdiff_negative)
+    {
+      sub_in_place(t1, 2u * half + 1u, prod_diff, 2u * half);
+    }
+    else
+    {
+      add_in_place(t1, 2u * half + 1u, prod_diff, 2u * half);
+    }
 
-        const uint64_t high_quot = high_words / d;
-        const uint64_t high_prod = high_quot * d;
-        // high_words = high_quot*d + r, where r<=d
-        increment_at_index_by_dword(ret_quotient, rsizem2, high_quot);
-        subtract_dword_from_MSDW(remainder, high_prod);      // decrease the remainder by same amount
-        rsize = remainder.size();
+    // Add t1 in at word half.  The product fits in rn words, so any carry out is zero.
+    const size_t t1n = std::min(2u * half + 1u, rn - half);
+    add_in_place(r + half, rn - half, t1, t1n);
+  }
 
+  // Blocked unbalanced multiply, r[0..an+bn) = a[0..an) * b[0..bn)
+  // precondition: KARATSUBA_THRESHOLD < an, 2*an < bn
+  //
+  // b is sliced into chunks of an words, so each chunk product is balanced and
+  // gets the fast algorithms.  The chunk products are added in at the chunk offsets,
+  // where each one overlaps the high half of the previous one.
+  static void mul_unbalanced_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn, uint32_t* scratch)
+  {
 #ifdef _DEBUG
-        vec32 denom;
-        denom.push_back(d);
-        assert(loop_invariant(n, denom, ret_quotient, remainder));
+    assert((KARATSUBA_THRESHOLD < an) && (2u * an < bn));
 #endif
-      }
-
-      // have reduced remainder to have size 1. Do 1 more divide if possible
-      if (rsize == 0)
+    // karatsuba_scratch_size(2*an) = 4*an+1 + karatsuba_scratch_size(an),
+    // so there is room for a chunk product and the scratch of a balanced multiply.
+    uint32_t* const product = scratch;
+    uint32_t* const next_scratch = scratch + 2u * an;
+    mul_dispatch(r, a, an, b, an, next_scratch);
+    for (size_t done(an); done < bn; done += an)
+    {
+      const size_t chunk = std::min(an, bn - done);
+      if (chunk == an)
       {
-        ret_remainder = 0;
+        mul_dispatch(product, a, an, b + done, chunk, next_scratch);
       }
       else
       {
-        if (remainder[0] >= d)
-        {
-          uint32_t quotient = remainder[0] / d;
-          remainder[0] -= (d*quotient);
-          increment_by_word(ret_quotient, quotient);
-        }
-        ret_remainder = remainder[0];
+        mul_dispatch(product, b + done, chunk, a, an, next_scratch);
+      }
+
+      // r[done, done+an) holds the high half of the previous products,
+      // the words above that are new.
+      std::copy(product + an, product + (an + chunk), r + (done + an));
+      add_in_place(r + done, an + chunk, product, an);
+    }
+  }
+
+  // r[0..2n) = a[0..n)**2, the elementary-school square.
+  // Each cross product a[i]*a[j], i < j, is computed once, and the sum of
+  // them is doubled before the squares a[i]**2 on the diagonal are added.
+  // precondition: n != 0, and r does not overlap a.
+  static void sqr_basecase(uint32_t* r, const uint32_t* a, const size_t n) noexcept
+  {
+    r[0] = 0u;
+    r[2u * n - 1u] = 0u;
+    if (n > 1u)
+    {
+      r[n] = mul_1(r + 1u, a + 1u, n - 1u, a[0]);
+      for (size_t i(1); i + 1u < n; ++i)
+      {
+        r[n + i] = addmul_1(r + 2u * i + 1u, a + i + 1u, n - i - 1u, a[i]);
       }
     }
 
-    // remove any 0 MSWs from the result
-    while ((ret_quotient.size() != 0) && (ret_quotient.back() == 0))
+    // r = 2*r + the diagonal, two words at a time
+    uint32_t shifted_out(0u);
+    uint64_t carry(0u);
+    for (size_t i(0); i < n; ++i)
     {
-      ret_quotient.pop_back();
+      const uint32_t lo = r[2u * i];
+      const uint32_t hi = r[2u * i + 1u];
+      const uint64_t square = uint64_t(a[i]) * a[i];
+      uint64_t t = uint64_t((lo << 1u) | shifted_out) + uint32_t(square) + carry;
+      r[2u * i] = uint32_t(t);
+      t = (t >> 32u) + uint32_t((hi << 1u) | (lo >> 31u)) + (square >> 32u);
+      r[2u * i + 1u] = uint32_t(t);
+      carry = (t >> 32u);
+      shifted_out = hi >> 31u;
     }
 #ifdef _DEBUG
-    assert(loop_invariant(n, d, quot_rem.first, quot_rem.second));
+    assert((carry == 0u) && (shifted_out == 0u));
 #endif
-    return quot_rem;
   }
 
+  // Karatsuba square,  r[0..2n) = a[0..n)**2
+  // precondition:  n > 1
+  //
+  // As for the multiply, with a = a0 + a1 << half,
+  //   a**2 = t0 + t1 << half + t2 << 2*half
+  // where t0 = a0**2, t2 = a1**2 and t1 = 2*a0*a1 = t0 + t2 - (a0-a1)**2,
+  // so the middle term is always a subtraction.  The memory layout is the
+  // same as mul_Karatsuba_n, so karatsuba_scratch_size(n) words of scratch are enough.
+  static void sqr_Karatsuba_n(uint32_t* r, const uint32_t* a, const size_t n, uint32_t* scratch)
+  {
+#ifdef _DEBUG
+    assert(n > 1u);
+#endif
+    const size_t half = n - n / 2u;
+    const size_t a1n = n - half;
+    const size_t rn = 2u * n;
+
+    uint32_t* const sqr_diff = scratch;
+    uint32_t* const diff = scratch + 2u * half;
+    uint32_t* const next_scratch = scratch + 4u * half + 1u;
+
+    abs_diff_n(diff, a, half, a + half, a1n);
+    sqr_dispatch(sqr_diff, diff, half, next_scratch);
+    sqr_dispatch(r, a, half, next_scratch);                 // t0
+    sqr_dispatch(r + 2u * half, a + half, a1n, next_scratch);  // t2
+
+    // t1 = t0 + t2 - (a0-a1)**2, uses 2*half+1 words
+    uint32_t* const t1 = diff;  // a0-a1 no longer needed
+    std::copy(r, r + 2u * half, t1);
+    t1[2u * half] = add_in_place(t1, 2u * half, r + 2u * half, 2u * a1n);
+    sub_in_place(t1, 2u * half + 1u, sqr_diff, 2u * half);
+
+    const size_t t1n = std::min(2u * half + 1u, rn - half);
+    add_in_place(r + half, rn - half, t1, t1n);
+  }
 
+  // r[0..2n) = a[0..n)**2, choosing the algorithm by size.
+  // precondition: 0 < n, and r does not overlap a or scratch.
+  // scratch must have room for karatsuba_scratch_size(n) words.
+  static void sqr_dispatch(uint32_t* r, const uint32_t* a, const size_t n, uint32_t* scratch)
+  {
+    if (n <= SQR_KARATSUBA_THRESHOLD)
+    {
+      sqr_basecase(r, a, n);
+    }
+    else if (use_NTT(n, n))
+    {
+      mul_NTT_n(r, a, n, a, n);
+    }
+    else if (use_Toom4(n, n))
+    {
+      mul_Toom4_n(r, a, n, a, n);
+    }
+    else if (use_Toom3(n, n))
+    {
+      mul_Toom3_n(r, a, n, a, n);
+    }
+    else
+    {
+      sqr_Karatsuba_n(r, a, n, scratch);
+    }
+  }
 
-
-  // div, divide n by d, returning a quotient and a remainder
-  // satisfies n = quot * d + rem,   where rem < d, unless d==0, in which case rem=d=0
-  std::pair< std::vector<uint32_t>, std::vector<uint32_t> > div_vec32(const std::vector<uint32_t>& n, const std::vector<uint32_t>& d)
+  bool mul_Karatsuba(std::vector<uint32_t>::const_iterator abegin, std::vector<uint32_t>::const_iterator aend,
+                     std::vector<uint32_t>::const_iterator bbegin, std::vector<uint32_t>::const_iterator bend,
+                     std::vector<uint32_t>::iterator out_iter)
   {
-    std::pair<vec32, vec32> result;
-    const bool is_zero_quotient = less_than(n, d);
-    const size_t nsize = n.size();
-    const size_t dsize = d.size();
+    const size_t an = size_t(aend - abegin);
+    const size_t bn = size_t(bend - bbegin);
+    if ((an > bn) || (bn > 2u * an))
+    {
+      return false;
+    }
+    if (an == 0u)
+    {
+      return true;  // nothing to write, the product is zero
+    }
 
-    if (dsize == 1)
+    vec32 scratch(karatsuba_scratch_size(bn) + 1u);
+    uint32_t* r = &(*out_iter);
+    const uint32_t* a = &(*abegin);
+    const uint32_t* b = &(*bbegin);
+    if (an <= KARATSUBA_THRESHOLD)
     {
-      // special case of 1-word divisor. Also handles divide-by-zero case.
-      std::pair<vec32, uint32_t> temp = div(n, d[0]);
-      result.first = temp.first;
-      result.second = vec32(1, temp.second);
-      //std::pair<vec32, vec32> result(temp.first, vec32(1, temp.second));
-#ifdef _DEBUG
-      assert(loop_invariant(n, d, result.first, result.second));
-#endif
-      return result;
+      mul_basecase(r, a, an, b, bn);
+    }
+    else
+    {
+      mul_Karatsuba_n(r, a, an, b, bn, scratch.data());
     }
+    return true;
+  }
 
-    const size_t quotient_num_words = is_zero_quotient ? size_t(1u) : (nsize - dsize + 1u);
-    const size_t remainder_num_words = test_zero(d) ? 1u : (is_zero_quotient ? nsize : dsize);
+  // precondition: a.size() <= b.size()
+  static vec32 mul_ordered_dispatch(const vec32& a, const vec32& b)
+  {
+    const size_t a_size(a.size());
+    const size_t b_size(b.size());
+    if (a_size <= KARATSUBA_THRESHOLD)
+    {
+      return mul_ordered(a, b);
+    }
 
-    // allocate memory for the returned quotient, zero filling it.
-    // It might be 1 word too large and may need a pop_back to preserve the invariant (quotient.back() != 0u)
-    result.first = vec32(quotient_num_words, 0u);
-    result.second = vec32(remainder_num_words, 0u);
+    vec32 result(a_size + b_size);
+    vec32 scratch(karatsuba_scratch_size(std::min(b_size, 2u * a_size)));
+    mul_dispatch(result.data(), a.data(), a_size, b.data(), b_size, scratch.data());
 
-    if (test_nonzero(d))
+    // the product of nonzero numbers has either a_size+b_size or a_size+b_size-1 words
+    if (result.back() == 0u)
     {
-      // some more meaningful names
-      vec32& ret_quotient = result.first;
-      vec32& ret_remainder = result.second;
+      result.pop_back();
+    }
+    return result;
+  }
 
-      ret_remainder = n;   // copy the numerator
+  std::vector<uint32_t> sqr_vec32(const std::vector<uint32_t>& a)
+  {
+    const size_t n(a.size());
+    if (n == 0u)
+    {
+      return vec32();
+    }
 
-                 // at this point, have established the invariant
-                 // n = quotient*d + remainder; 
-                 // underestimate the quotient and keep subtracting until remainder < d
-      size_t rsize = ret_remainder.size();
-      const uint32_t d_MSW = d.back();  // get the MSW of the divisor
-      const uint64_t d_MSDW = (uint64_t(d_MSW) << 32u) + d[dsize - 2];
-#ifdef _DEBUG
-      assert(loop_invariant(n, d, ret_quotient, ret_remainder));
-#endif
-      //size_t loopcount(0);
-      while (not less_than(ret_remainder, d))   // ensures the (remainder < d) postcondition, same as while r>=d
-      {
-        //++loopcount;
-#ifdef _DEBUG
-        assert(rsize >= dsize);  // r >=d implies rsize >= dsize >= 2
-#endif
-                     // since the smallest rsize can be is two, that is the base case
-                     // for exiting the loop.  Otherwise keep reducing remainder.
-        if (ret_remainder.size() == 2u)   // A base case for exiting loop
-        {
-          // can do this last step exactly.
-          const uint64_t rem_dword = (uint64_t(ret_remainder[1u]) << 32u) + ret_remainder[0];
-          const uint64_t quot_dword = rem_dword / d_MSDW;
-          // since d_MSDW is nonzero in MSW, this quotient really fits in 32 bits.
-          const uint32_t quot_word = uint32_t(quot_dword);
-          const uint64_t prod_dword = quot_dword * d_MSDW;
-          increment_by_word(ret_quotient, quot_word);  // increase the quotient
-          subtract_dword_from_MSDW(ret_remainder, prod_dword);  // decrease the remainder
-#ifdef _DEBUG
-          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
-#endif
-          break;  //out of loop
-        }
+    vec32 result(2u * n);
+    vec32 scratch(karatsuba_scratch_size(n));
+    sqr_dispatch(result.data(), a.data(), n, scratch.data());
 
-        const uint64_t rem_MSWs = (uint64_t(ret_remainder[rsize - 1u]) << 32) + uint64_t(ret_remainder[rsize - 2u]);
+    // the square of a nonzero number has either 2n or 2n-1 words
+    if (result.back() == 0u)
+    {
+      result.pop_back();
+    }
+    return result;
+  }
 
-        if (d_MSDW < rem_MSWs)
-        {
-          // can use d_MSDW for trial divide, it will give at least a quotient 1 with nonzero remainder
-          // because the MSW of div_word is nonzero, this results in a single-word quotient
-          const uint64_t high_quotd = rem_MSWs / d_MSDW;
-#ifdef _DEBUG
-          assert(high_quotd < 0x1'0000'0000ull);
-#endif
-          const uint32_t high_quotw = uint32_t(high_quotd);
-          const size_t index_of_work(rsize - dsize);  // note rsize>=dsize since remainder >=d
-          sub_product_at_index(ret_remainder, index_of_work, d, high_quotw);
-          increment_at_index_by_word(ret_quotient, index_of_work, high_quotw);  // increase the (quotient*d) value
+  std::vector<uint32_t> mul_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+  {
+    if (&a == &b)
+    {
+      return sqr_vec32(a);
+    }
+    return a.size() < b.size()
+      ? mul_ordered_dispatch(a, b)
+      : mul_ordered_dispatch(b, a);
+  }
+
+  // The block products must not allocate, so they have to stay below the Toom sizes.
+  static_assert(PROD_GENERATOR_BLOCK_SIZE < TOOM3_THRESHOLD, "generator blocks must use Karatsuba");
+  static_assert(PROD_GENERATOR_BLOCK_SIZE < NTT_THRESHOLD, "generator blocks must use Karatsuba");
+
+  Prod_Karatsuba_generator::Prod_Karatsuba_generator(
+    std::vector<uint32_t>::const_iterator abegin, std::vector<uint32_t>::const_iterator aend,
+    std::vector<uint32_t>::const_iterator bbegin, std::vector<uint32_t>::const_iterator bend)
+    : m_a((abegin == aend) ? nullptr : &(*abegin))
+    , m_asize(size_t(aend - abegin))
+    , m_b((bbegin == bend) ? nullptr : &(*bbegin))
+    , m_bsize(size_t(bend - bbegin))
+  {}
+
+  Prod_Karatsuba_generator::iterator::iterator(const Prod_Karatsuba_generator& the_parent, End_tag_t)
+    : m_parent(&the_parent)
+    , m_block(0u)
+    , m_index(0u)
+    , m_value(0u)
+    , m_done(true)
+  {}
+
+  Prod_Karatsuba_generator::iterator::iterator(const Prod_Karatsuba_generator& the_parent)
+    : m_parent(&the_parent)
+    , m_block(0u)
+    , m_index(0u)
+    , m_value(0u)
+    , m_done(true)
+  {
+    const size_t block = PROD_GENERATOR_BLOCK_SIZE;
+    const size_t asize = m_parent->m_asize;
+    const size_t bsize = m_parent->m_bsize;
+    if ((asize == 0u) || (bsize == 0u))
+    {
+      return;  // the product is zero
+    }
+
+    // all the memory used by the iterator
+    m_window.assign(2u * block + 2u, 0u);
+    m_product.resize(2u * block);
+    m_scratch.resize(karatsuba_scratch_size(block));
+    m_a_last.assign(block, 0u);
+    m_b_last.assign(block, 0u);
+    const size_t a_last_start = ((asize - 1u) / block) * block;
+    const size_t b_last_start = ((bsize - 1u) / block) * block;
+    std::copy(m_parent->m_a + a_last_start, m_parent->m_a + asize, m_a_last.begin());
+    std::copy(m_parent->m_b + b_last_start, m_parent->m_b + bsize, m_b_last.begin());
+
+    m_done = false;
+    sum_diagonal();
+    set_value();
+  }
+
+  const uint32_t* Prod_Karatsuba_generator::iterator::block_of_a(const size_t i) const noexcept
+  {
+    const size_t start = i * PROD_GENERATOR_BLOCK_SIZE;
+    return (start + PROD_GENERATOR_BLOCK_SIZE < m_parent->m_asize) ? m_parent->m_a + start : m_a_last.data();
+  }
+
+  const uint32_t* Prod_Karatsuba_generator::iterator::block_of_b(const size_t j) const noexcept
+  {
+    const size_t start = j * PROD_GENERATOR_BLOCK_SIZE;
+    return (start + PROD_GENERATOR_BLOCK_SIZE < m_parent->m_bsize) ? m_parent->m_b + start : m_b_last.data();
+  }
+
+  void Prod_Karatsuba_generator::iterator::sum_diagonal()
+  {
+    const size_t block = PROD_GENERATOR_BLOCK_SIZE;
+    const size_t a_blocks = (m_parent->m_asize + block - 1u) / block;
+    const size_t b_blocks = (m_parent->m_bsize + block - 1u) / block;
+    const size_t k = m_block;
+    if (k + 1u >= a_blocks + b_blocks)
+    {
+      return;  // past the last diagonal, only the high words of the window are left
+    }
+
+    // blocks i of a and j=k-i of b, with i < a_blocks and j < b_blocks
+    const size_t i_first = (k >= b_blocks) ? k - (b_blocks - 1u) : 0u;
+    const size_t i_last = std::min(k, a_blocks - 1u);
+    for (size_t i(i_first); i <= i_last; ++i)
+    {
+      mul_dispatch(m_product.data(), block_of_a(i), block, block_of_b(k - i), block, m_scratch.data());
+      add_in_place(m_window.data(), m_window.size(), m_product.data(), m_product.size());
+    }
+  }
+
+  void Prod_Karatsuba_generator::iterator::set_value() noexcept
+  {
+    const size_t total = m_parent->m_asize + m_parent->m_bsize;
+    m_value = m_window[m_index - m_block * PROD_GENERATOR_BLOCK_SIZE];
+    // the product has total or total-1 words
+    if ((m_index == total) || ((m_index + 1u == total) && (m_value == 0u)))
+    {
+      m_done = true;
+      m_value = 0u;
+    }
+  }
+
+  Prod_Karatsuba_generator::iterator& Prod_Karatsuba_generator::iterator::operator++()
+  {
+    if (m_done)
+    {
+      return *this;  // ++ has no effect if done
+    }
+
+    const size_t block = PROD_GENERATOR_BLOCK_SIZE;
+    ++m_index;
+    if (m_index == (m_block + 1u) * block)
+    {
+      // the low block of the window has been returned, move on to the next diagonal
+      std::copy(m_window.begin() + block, m_window.end(), m_window.begin());
+      std::fill(m_window.end() - block, m_window.end(), 0u);
+      ++m_block;
+      sum_diagonal();
+    }
+    set_value();
+    return *this;
+  }
+
+  bool Prod_Karatsuba_generator::iterator::operator==(const iterator& rhs) const noexcept
+  {
+    if (m_done != rhs.m_done)
+    {
+      return false;  // one is at end and other is not
+    }
+    return m_done ||    // both end iterators, so equal
+      ((m_parent == rhs.m_parent) && (m_index == rhs.m_index));
+  }
+
+  // the convolution multiply, no matter what the size.  Useful as a reference.
+  std::vector<uint32_t> mul_conv(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+  {
+    return a.size() < b.size()
+      ? mul_ordered(a, b)
+      : mul_ordered(b, a);
+  }
+
+  bool loop_invariant(const vec32& numerator, const uint32_t divisor, const vec32& quotient, const uint32_t remainder)
+  {
+    // predicate to assert numerator = quotient*divisor + remainder
+    // Allows quotient to be de-normalized (can have MSW zero).
+
+    // first, make a normalized version of the quotient.
+    vec32 q = quotient;
+    // remove any 0 MSWs left in the quotient
+    while ((q.size() != 0) && (q.back() == 0))
+    {
+      q.pop_back();
+    }
+    vec32 prod = mul_vec32_by_word(q, divisor);
+
+    vec32 sum = add_vec32_and_word(prod, remainder);
+    const bool return_val(sum == numerator);
+    return return_val;
+  }
+
+
+  bool loop_invariant(const vec32& numerator, const vec32& divisor, const vec32& quotient, const vec32& remainder)
+  {
+    // predicate to assert numerator = quotient*divisor + remainder
+    // Allows quotient to be de-normalized (can have MSW zero).
+
+    // first, make a normalized version of the quotient.
+    vec32 q = quotient;
+    // remove any 0 MSWs left in the quotient
+    while ((q.size() != 0) && (q.back() == 0))
+    {
+      q.pop_back();
+    }
+    vec32 prod = mul_vec32(q, divisor);
+
+    const size_t r_size = remainder.size();
+    const size_t p_size = prod.size();
+
+    vec32 sum = add_vec32(prod, remainder);
+    const bool return_val(sum == numerator);
+    return return_val;
+  }
+
+  // number of leading zero bits of a nonzero word
+  static unsigned leading_zeros(uint32_t w) noexcept
+  {
+    unsigned count(0u);
+    while ((w & 0x8000'0000u) == 0u)
+    {
+      w <<= 1u;
+      ++count;
+    }
+    return count;
+  }
+
+  Word_divisor::Word_divisor(const uint32_t d) noexcept
+    : m_divisor(d), m_normalized(0u), m_inverse(0u), m_shift(0u)
+  {
+    if (d != 0u)
+    {
+      m_shift = leading_zeros(d);
+      m_normalized = d << m_shift;
+      m_inverse = uint32_t(0xffff'ffff'ffff'ffffull / m_normalized - 0x1'0000'0000ull);
+    }
+  }
+
+  // Moller and Granlund's division of (u1,u0) by the normalized divisor, where u1 < divisor.
+  // Returns the quotient word and sets the remainder.
+  // (u1,u0)*inverse/B gives a quotient that is one too small or right, or very rarely
+  // one too large, so only two cheap adjustments are needed.
+  uint32_t Word_divisor::div_2by1(const uint32_t u1, const uint32_t u0, uint32_t& remainder) const noexcept
+  {
+    const uint64_t q = uint64_t(m_inverse) * u1 + ((uint64_t(u1) << 32u) | u0);
+    uint32_t q1 = uint32_t(q >> 32u) + 1u;
+    const uint32_t q0 = uint32_t(q);
+    uint32_t r = u0 - q1 * m_normalized;
+    if (r > q0)
+    {
+      --q1;
+      r += m_normalized;
+    }
+    if (r >= m_normalized)
+    {
+      ++q1;
+      r -= m_normalized;
+    }
+    remainder = r;
+    return q1;
+  }
+
+  uint32_t Word_divisor::divrem(uint32_t* q, const uint32_t* a, const size_t n) const noexcept
+  {
+    if (n == 0u)
+    {
+      return 0u;
+    }
+    // divide a << m_shift by m_normalized, which gives the same quotient
+    const unsigned shift = m_shift;
+    uint32_t r(0u);
+    if (shift == 0u)
+    {
+      for (size_t i(n); i != 0u; )
+      {
+        --i;
+        q[i] = div_2by1(r, a[i], r);
+      }
+      return r;
+    }
+    r = a[n - 1u] >> (32u - shift);
+    for (size_t i(n - 1u); i != 0u; --i)
+    {
+      const uint32_t u0 = (a[i] << shift) | (a[i - 1u] >> (32u - shift));
+      q[i] = div_2by1(r, u0, r);
+    }
+    q[0] = div_2by1(r, a[0] << shift, r);
+    return r >> shift;
+  }
+
+  uint32_t Word_divisor::mod(const uint32_t* a, const size_t n) const noexcept
+  {
+    // as divrem, without storing the quotient
+    uint32_t r(0u);
+    if (n == 0u)
+    {
+      return r;
+    }
+    const unsigned shift = m_shift;
+    if (shift == 0u)
+    {
+      for (size_t i(n); i != 0u; )
+      {
+        --i;
+        div_2by1(r, a[i], r);
+      }
+      return r;
+    }
+    r = a[n - 1u] >> (32u - shift);
+    for (size_t i(n - 1u); i != 0u; --i)
+    {
+      div_2by1(r, (a[i] << shift) | (a[i - 1u] >> (32u - shift)), r);
+    }
+    div_2by1(r, a[0] << shift, r);
+    return r >> shift;
+  }
+
+  std::pair<vec32, uint32_t> div(const vec32& n, const Word_divisor& d)
+  {
+    std::pair<vec32, uint32_t> quot_rem(vec32(), 0u);
+    const size_t nsize = n.size();
+    if ((nsize == 0u) || (d.divisor() == 0u))
+    {
+      return quot_rem;
+    }
+
+    // the quotient is written once, and has at most one MSW zero
+    vec32& quotient = quot_rem.first;
+    quotient.resize(nsize);
+    quot_rem.second = d.divrem(quotient.data(), n.data(), nsize);
+    if (quotient.back() == 0u)
+    {
+      quotient.pop_back();
+    }
 #ifdef _DEBUG
-          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+    assert(loop_invariant(n, d.divisor(), quot_rem.first, quot_rem.second));
 #endif
-        }
-        else if (d_MSDW == rem_MSWs)
-        {
-          if (rsize == dsize)
-          {
-            // r is nearly equal to d, just subtract d from r and exit
-            decrement_by(ret_remainder, d);
-            const uint32_t one(1u);
-            increment_by_word(ret_quotient, one);  // increase the (quotient*d) value
+    return quot_rem;
+  }
+
+  // div, divide n by d, returning a quotient and a remainder
+  // satisfies n = quot * d + rem,   where rem < d, unless d==0, in which case rem=d=0
+  std::pair<vec32, uint32_t> div(const vec32& n, const uint32_t d)
+  {
+    return div(n, Word_divisor(d));
+  }
+
+  // number of trailing zero bits of a nonzero word
+  static unsigned trailing_zeros(uint32_t w) noexcept
+  {
+    unsigned count(0u);
+    while ((w & 1u) == 0u)
+    {
+      w >>= 1u;
+      ++count;
+    }
+    return count;
+  }
+
+  // inverse of an odd word modulo 2**32.  Newton's iteration x' = x*(2 - w*x)
+  // doubles the number of correct low bits, and x = w is right to 3 bits.
+  static uint32_t inverse_mod_word(const uint32_t w) noexcept
+  {
+    uint32_t x = w;
+    for (unsigned i(0); i < 4u; ++i)
+    {
+      x *= 2u - w * x;
+    }
+    return x;
+  }
+
+  // q[0..n) = a[0..n) / d, where d divides a exactly (Jebelean's exact division).
+  // It works from the LSW, each quotient word is the low word of what is left
+  // times the inverse of d mod 2**32, so there are no trial quotients and no remainder.
+  // q may be the same as a.  precondition: d != 0
+  static void divexact_1(uint32_t* q, const uint32_t* a, const size_t n, uint32_t d) noexcept
+  {
+    const unsigned shift = trailing_zeros(d);
+    d >>= shift;
+    const uint32_t inverse = inverse_mod_word(d);
+    uint32_t borrow(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      uint32_t w = a[i];
+      if (shift != 0u)
+      {
+        // a >> shift, the bits shifted out are zero
+        w = (w >> shift) | ((i + 1u < n) ? (a[i + 1u] << (32u - shift)) : 0u);
+      }
+      const uint32_t x = w - borrow;
+      const uint32_t qi = x * inverse;
+      q[i] = qi;
+      borrow = uint32_t((uint64_t(qi) * d) >> 32u) + (x > w);
+    }
+  }
+
+
+
+
+  // A signed number for the Toom-Cook evaluation and interpolation.
+  // The magnitude is in vec32 format, and zero is never negative.
+  struct Signed_vec32
+  {
+    vec32 mag;
+    bool negative;
+  };
+
+  static Signed_vec32 signed_add(const Signed_vec32& a, const Signed_vec32& b)
+  {
+    Signed_vec32 result;
+    if (a.negative == b.negative)
+    {
+      result.mag = add_vec32(a.mag, b.mag);
+      result.negative = a.negative;
+    }
+    else
+    {
+      // a + b has the sign of the one with the larger magnitude
+      std::pair<vec32, bool> diff = symdiff_vec32(a.mag, b.mag);  // second is true if a.mag > b.mag
+      result.mag = std::move(diff.first);
+      result.negative = diff.second ? a.negative : b.negative;
+    }
+    result.negative &= test_nonzero(result.mag);
+    return result;
+  }
+
+  static Signed_vec32 signed_sub(const Signed_vec32& a, const Signed_vec32& b)
+  {
+    const Signed_vec32 minus_b = { b.mag, test_nonzero(b.mag) && not b.negative };
+    return signed_add(a, minus_b);
+  }
+
+  static Signed_vec32 signed_mul(const Signed_vec32& a, const Signed_vec32& b)
+  {
+    Signed_vec32 result = { mul_vec32(a.mag, b.mag), false };
+    result.negative = (a.negative != b.negative) && test_nonzero(result.mag);
+    return result;
+  }
+
+  static Signed_vec32 signed_sqr(const Signed_vec32& a)
+  {
+    Signed_vec32 result = { sqr_vec32(a.mag), false };
+    return result;
+  }
+
+  static Signed_vec32 signed_scale(const Signed_vec32& a, const uint32_t w)
+  {
+    Signed_vec32 result = { mul_vec32_by_word(a.mag, w), a.negative };
+    return result;
+  }
+
+  // precondition: w divides a exactly
+  static Signed_vec32 signed_divexact(const Signed_vec32& a, const uint32_t w)
+  {
 #ifdef _DEBUG
-            assert(loop_invariant(n, d, ret_quotient, ret_remainder));
-            assert(less_than(ret_remainder, d));
+    assert(div(a.mag, w).second == 0u);
 #endif
-            break;
-          }
+    Signed_vec32 result = { a.mag, a.negative };
+    divexact_1(result.mag.data(), result.mag.data(), result.mag.size(), w);
+    remove_MSW_zeros(result.mag);
+    return result;
+  }
 
-          // quotient is darn nearly 1. use 0xffffffff as an estimated quotient, with a word shift (see index_of_work)
+  // words [index*size, (index+1)*size) of p[0..n), as a vec32
+  static Signed_vec32 toom_piece(const uint32_t* p, const size_t n, const size_t index, const size_t size)
+  {
+    Signed_vec32 piece = { vec32(), false };
+    const size_t start = std::min(n, index * size);
+    size_t end = std::min(n, start + size);
+    while ((end != start) && (p[end - 1u] == 0u))
+    {
+      --end;  // keep the vec32 invariant, MSW nonzero
+    }
+    piece.mag.assign(p + start, p + end);
+    return piece;
+  }
+
+  // r[0..rn) = sum of c[i] << (i*size words)
+  // precondition: every c[i] is non-negative, and the sum fits in rn words.
+  static void toom_recompose(uint32_t* r, const size_t rn, const std::vector<Signed_vec32>& c, const size_t size)
+  {
+    std::fill(r, r + rn, 0u);
+    for (size_t i(0); i < c.size(); ++i)
+    {
+      const vec32& coeff = c[i].mag;
 #ifdef _DEBUG
-          assert(rsize > dsize);  // Since already handled rsize == dsize, it must be rsize > dsize.
+      assert(not c[i].negative);
+      assert(test_zero(coeff) || (i * size + coeff.size() <= rn));
 #endif
-          const size_t index_of_work = rsize - dsize - 1u;  // ok since rsize > dsize
-          const uint32_t quot_w = 0xffff'ffffu;
-          // proof that quotient is not too big:
-          // Need to verify that r >= q*d
-          // Since r and d have equal MSWs, this inequality holds:
-          // r + 2**32(rs-2) > d * 2**32(rs-ds)  where rs=rsize, ds = dsize.
-          // rearranging gives
-          // r > d*(2**32(rs-ds)-k) + (k*d - 2**32(rs-2))   where choose k=2**32(rs-ds-1)
-          // the last term is >=0 because d>=2**32(ds-1)  (the MSW of d is >=1)
-          // dropping the (non-negative) last term gives
-          // r > d*(2**32(rs-ds)-2**32(rs-ds-1))
-          // r > d*q  where q = 0xffffffff * 2**32(rs-ds-1)
-          // QED
+      if (test_nonzero(coeff))
+      {
+        add_in_place(r + i * size, rn - i * size, coeff.data(), coeff.size());
+      }
+    }
+  }
+
+  // Toom-Cook 3-way multiply, r[0..an+bn) = a[0..an) * b[0..bn)
+  // precondition: 0 < an <= bn
+  //
+  // Split into pieces of size = ceil(bn/3) words, and view a and b as
+  // polynomials of degree 2 in x = 2**(32*size).  Evaluate at the points
+  // 0, 1, -1, -2 and infinity, multiply the 5 values (recursively through mul_vec32),
+  // then interpolate for the 5 coefficients of the product polynomial.
+  // The interpolation sequence is the one by Bodrato.
+  // If a and b are the same range, only one operand is evaluated and the values are squared.
+  static void mul_Toom3_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn)
+  {
+    const size_t size = (bn + 2u) / 3u;
+    const bool is_square = (a == b) && (an == bn);
+    Signed_vec32 w[5];  // values of the product at 0, 1, -1, -2, infinity
+    {
+      Signed_vec32 av[5];
+      Signed_vec32 bv[5];
+      const uint32_t* const operand[2] = { a, b };
+      const size_t operand_size[2] = { an, bn };
+      Signed_vec32* const value[2] = { av, bv };
+      for (size_t k(0); k < (is_square ? 1u : 2u); ++k)
+      {
+        const Signed_vec32 p0 = toom_piece(operand[k], operand_size[k], 0u, size);
+        const Signed_vec32 p1 = toom_piece(operand[k], operand_size[k], 1u, size);
+        const Signed_vec32 p2 = toom_piece(operand[k], operand_size[k], 2u, size);
+        const Signed_vec32 even = signed_add(p0, p2);
+        Signed_vec32* const v = value[k];
+        v[0] = p0;
+        v[1] = signed_add(even, p1);
+        v[2] = signed_sub(even, p1);
+        v[3] = signed_sub(signed_scale(signed_add(v[2], p2), 2u), p0);  // p0 - 2*p1 + 4*p2
+        v[4] = p2;
+      }
+      for (size_t i(0); i < 5u; ++i)
+      {
+        w[i] = is_square ? signed_sqr(av[i]) : signed_mul(av[i], bv[i]);
+      }
+    }
 
+    std::vector<Signed_vec32> c(5u);
+    c[0] = w[0];
+    c[4] = w[4];
+    Signed_vec32 r3 = signed_divexact(signed_sub(w[3], w[1]), 3u);
+    Signed_vec32 r1 = signed_divexact(signed_sub(w[1], w[2]), 2u);
+    Signed_vec32 r2 = signed_sub(w[2], w[0]);
+    r3 = signed_add(signed_divexact(signed_sub(r2, r3), 2u), signed_scale(w[4], 2u));
+    c[2] = signed_sub(signed_add(r2, r1), w[4]);
+    c[1] = signed_sub(r1, r3);
+    c[3] = std::move(r3);
+
+    toom_recompose(r, an + bn, c, size);
+  }
 
-          // ret_remainder -= word_shift( d*high_quotw, index_of_work)
-          sub_product_at_index(ret_remainder, index_of_work, d, quot_w);
-          //const vec32 product = mul_vec32_by_word(d, quot_w);
-          //decrement_at_index(ret_remainder, index_of_work, product);  // decrement remainder by product at index
+  // Toom-Cook 4-way multiply, r[0..an+bn) = a[0..an) * b[0..bn)
+  // precondition: 0 < an <= bn
+  //
+  // Split into pieces of size = ceil(bn/4) words, so a and b are polynomials
+  // of degree 3.  Evaluate at the points 0, 1, -1, 2, -2, 3 and infinity,
+  // multiply the 7 values, then interpolate for the 7 coefficients c0..c6:
+  //   c0 = W(0),  c6 = W(inf)
+  //   E1 = (W(1)+W(-1))/2 - c0 - c6          = c2 + c4
+  //   E2 = ((W(2)+W(-2))/2 - c0 - 64*c6)/4   = c2 + 4*c4
+  //   O1 = (W(1)-W(-1))/2                    = c1 + c3 + c5
+  //   O2 = (W(2)-W(-2))/4                    = c1 + 4*c3 + 16*c5
+  //   O3 = (W(3)-c0-9*c2-81*c4-729*c6)/3     = c1 + 9*c3 + 81*c5
+  // then c4 = (E2-E1)/3, c2 = E1-c4, and with D1 = (O2-O1)/3 = c3+5*c5,
+  // D2 = (O3-O1)/8 = c3+10*c5, c5 = (D2-D1)/5, c3 = D1-5*c5, c1 = O1-c3-c5.
+  // All the divisions are exact.  Squares are done as in mul_Toom3_n.
+  static void mul_Toom4_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn)
+  {
+    const size_t size = (bn + 3u) / 4u;
+    const bool is_square = (a == b) && (an == bn);
+    Signed_vec32 w[7];  // values of the product at 0, 1, -1, 2, -2, 3, infinity
+    {
+      Signed_vec32 av[7];
+      Signed_vec32 bv[7];
+      const uint32_t* const operand[2] = { a, b };
+      const size_t operand_size[2] = { an, bn };
+      Signed_vec32* const value[2] = { av, bv };
+      for (size_t k(0); k < (is_square ? 1u : 2u); ++k)
+      {
+        const Signed_vec32 p0 = toom_piece(operand[k], operand_size[k], 0u, size);
+        const Signed_vec32 p1 = toom_piece(operand[k], operand_size[k], 1u, size);
+        const Signed_vec32 p2 = toom_piece(operand[k], operand_size[k], 2u, size);
+        const Signed_vec32 p3 = toom_piece(operand[k], operand_size[k], 3u, size);
+        const Signed_vec32 even1 = signed_add(p0, p2);
+        const Signed_vec32 odd1 = signed_add(p1, p3);
+        const Signed_vec32 even2 = signed_add(p0, signed_scale(p2, 4u));
+        const Signed_vec32 odd2 = signed_add(signed_scale(p1, 2u), signed_scale(p3, 8u));
+        Signed_vec32* const v = value[k];
+        v[0] = p0;
+        v[1] = signed_add(even1, odd1);
+        v[2] = signed_sub(even1, odd1);
+        v[3] = signed_add(even2, odd2);
+        v[4] = signed_sub(even2, odd2);
+        v[5] = signed_add(signed_scale(signed_add(signed_scale(signed_add(signed_scale(p3, 3u), p2), 3u), p1), 3u), p0);
+        v[6] = p3;
+      }
+      for (size_t i(0); i < 7u; ++i)
+      {
+        w[i] = is_square ? signed_sqr(av[i]) : signed_mul(av[i], bv[i]);
+      }
+    }
+
+    std::vector<Signed_vec32> c(7u);
+    c[0] = w[0];
+    c[6] = w[6];
+    const Signed_vec32 e1 = signed_sub(signed_sub(signed_divexact(signed_add(w[1], w[2]), 2u), c[0]), c[6]);
+    const Signed_vec32 e2 = signed_divexact(
+      signed_sub(signed_sub(signed_divexact(signed_add(w[3], w[4]), 2u), c[0]), signed_scale(c[6], 64u)), 4u);
+    const Signed_vec32 o1 = signed_divexact(signed_sub(w[1], w[2]), 2u);
+    const Signed_vec32 o2 = signed_divexact(signed_sub(w[3], w[4]), 4u);
+    c[4] = signed_divexact(signed_sub(e2, e1), 3u);
+    c[2] = signed_sub(e1, c[4]);
+    Signed_vec32 o3 = signed_sub(w[5], c[0]);
+    o3 = signed_sub(o3, signed_scale(c[2], 9u));
+    o3 = signed_sub(o3, signed_scale(c[4], 81u));
+    o3 = signed_divexact(signed_sub(o3, signed_scale(c[6], 729u)), 3u);
+    const Signed_vec32 d1 = signed_divexact(signed_sub(o2, o1), 3u);
+    const Signed_vec32 d2 = signed_divexact(signed_sub(o3, o1), 8u);
+    c[5] = signed_divexact(signed_sub(d2, d1), 5u);
+    c[3] = signed_sub(d1, signed_scale(c[5], 5u));
+    c[1] = signed_sub(signed_sub(o1, c[3]), c[5]);
+
+    toom_recompose(r, an + bn, c, size);
+  }
+
+  // Number-theoretic transform (NTT) multiply.
+  //
+  // Each operand is cut into 16-bit pieces, and the convolution of the pieces is
+  // computed modulo three primes of the form k*2**m+1 using fast transforms.
+  // The convolution is then recombined with the Chinese remainder theorem (Garner's method).
+  // A coefficient of the convolution is less than 2**25 * 2**32 = 2**57,
+  // and the product of the primes is about 2**87, so the recombination is exact.
+
+  struct Ntt_prime
+  {
+    uint32_t p;          // the prime, p < 2**31
+    uint32_t generator;  // a primitive root mod p
+  };
+
+  static const Ntt_prime ntt_primes[3] = {
+    { 2013265921u, 31u },    // 15*2**27+1
+    { 469762049u, 3u },      // 7*2**26+1
+    { 167772161u, 3u } };    // 5*2**25+1
+
+  // arithmetic mod a prime p < 2**31.
+  // mul() is a Montgomery multiply, a*b/2**32 mod p, so if one factor is
+  // in Montgomery form (x*2**32 mod p) the result is an ordinary product.
+  class Ntt_field
+  {
+  public:
+    explicit Ntt_field(const uint32_t prime)
+      : m_p(prime)
+      , m_p_inv_neg(0u)
+    {
+      // Newton iteration for 1/p mod 2**32, each step doubles the correct bits
+      uint32_t inv(prime);
+      for (int i(0); i < 5; ++i)
+      {
+        inv *= 2u - prime * inv;
+      }
+      m_p_inv_neg = 0u - inv;
+    }
+
+    // The reductions are branch free, the transforms see random data.
+    // As p < 2**31, a value in (-p, p) is negative exactly when its top bit is set.
+    uint32_t add(const uint32_t a, const uint32_t b) const noexcept
+    {
+      return reduce(a + b - m_p);
+    }
+
+    uint32_t sub(const uint32_t a, const uint32_t b) const noexcept
+    {
+      return reduce(a - b);
+    }
+
+    uint32_t mul(const uint32_t a, const uint32_t b) const noexcept
+    {
+      const uint64_t t = uint64_t(a) * b;
+      const uint32_t m = uint32_t(t) * m_p_inv_neg;
+      const uint32_t u = uint32_t((t + uint64_t(m) * m_p) >> 32u);  // t+m*p < 2**62 + 2**63
+      return reduce(u - m_p);
+    }
+
+    // the slow (hardware divide) versions, only used for setting up constants
+    uint32_t mul_mod(const uint32_t a, const uint32_t b) const noexcept
+    {
+      return uint32_t((uint64_t(a) * b) % m_p);
+    }
+
+    uint32_t pow_mod(uint32_t base, uint64_t e) const noexcept
+    {
+      uint32_t result(1u);
+      while (e != 0u)
+      {
+        if (e & 1u)
+        {
+          result = mul_mod(result, base);
+        }
+        base = mul_mod(base, base);
+        e >>= 1u;
+      }
+      return result;
+    }
+
+    uint32_t to_montgomery(const uint32_t a) const noexcept
+    {
+      return uint32_t((uint64_t(a) << 32u) % m_p);
+    }
+
+    uint32_t prime() const noexcept { return m_p; }
+
+  private:
+    // x in (-p, p) as a two's complement value, returns x mod p
+    uint32_t reduce(const uint32_t x) const noexcept
+    {
+      return x + (m_p & (0u - (x >> 31u)));
+    }
+
+    uint32_t m_p;
+    uint32_t m_p_inv_neg;  // -1/p mod 2**32
+  };
+
+  // The roots of unity used by a transform of length n, in Montgomery form.
+  // w is a primitive n-th root of unity.  The butterflies with half-length len
+  // use the roots w**(j*n/(2*len)) for j in [0, len), and these are stored
+  // contiguously at roots[len + j], so that each pass reads them sequentially.
+  static vec32 ntt_roots(const Ntt_field& f, const uint32_t w, const size_t n)
+  {
+    vec32 roots(n);
+    const size_t half = n / 2u;
+    if (half != 0u)
+    {
+      const uint32_t w_montgomery = f.to_montgomery(w);
+      roots[half] = f.to_montgomery(1u);
+      for (size_t j(1); j < half; ++j)
+      {
+        roots[half + j] = f.mul(roots[half + j - 1u], w_montgomery);
+      }
+      for (size_t len(half / 2u); len != 0u; len /= 2u)
+      {
+        for (size_t j(0); j < len; ++j)
+        {
+          roots[len + j] = roots[2u * (len + j)];
+        }
+      }
+    }
+    return roots;
+  }
+
+  // Transforms of at most this length are done a pass at a time.
+  // Longer ones recurse on the halves, so that most passes are done in cache.
+  const size_t NTT_BLOCK_SIZE = 4096u;
+
+  // forward transform of a[0..n), n a power of 2.
+  // Decimation in frequency, so the output is in bit-reversed order.
+  static void ntt_forward(uint32_t* a, const size_t n, const vec32& roots, const Ntt_field& f) noexcept
+  {
+    if (n > NTT_BLOCK_SIZE)
+    {
+      const size_t half = n / 2u;
+      const uint32_t* const w = roots.data() + half;
+      uint32_t* const hi = a + half;
+      for (size_t j(0); j < half; ++j)
+      {
+        const uint32_t u = a[j];
+        const uint32_t v = hi[j];
+        a[j] = f.add(u, v);
+        hi[j] = f.mul(f.sub(u, v), w[j]);
+      }
+      ntt_forward(a, half, roots, f);
+      ntt_forward(hi, half, roots, f);
+      return;
+    }
+
+    for (size_t len(n / 2u); len != 0u; len /= 2u)
+    {
+      const uint32_t* const w = roots.data() + len;
+      for (size_t i(0); i < n; i += 2u * len)
+      {
+        uint32_t* const lo = a + i;
+        uint32_t* const hi = lo + len;
+        for (size_t j(0); j < len; ++j)
+        {
+          const uint32_t u = lo[j];
+          const uint32_t v = hi[j];
+          lo[j] = f.add(u, v);
+          hi[j] = f.mul(f.sub(u, v), w[j]);
+        }
+      }
+    }
+  }
+
+  // inverse transform of a[0..n), without the scaling by 1/n.
+  // Decimation in time, so the input is in bit-reversed order and the output in natural order.
+  static void ntt_inverse(uint32_t* a, const size_t n, const vec32& inv_roots, const Ntt_field& f) noexcept
+  {
+    if (n > NTT_BLOCK_SIZE)
+    {
+      const size_t half = n / 2u;
+      const uint32_t* const w = inv_roots.data() + half;
+      uint32_t* const hi = a + half;
+      ntt_inverse(a, half, inv_roots, f);
+      ntt_inverse(hi, half, inv_roots, f);
+      for (size_t j(0); j < half; ++j)
+      {
+        const uint32_t u = a[j];
+        const uint32_t v = f.mul(hi[j], w[j]);
+        a[j] = f.add(u, v);
+        hi[j] = f.sub(u, v);
+      }
+      return;
+    }
+
+    for (size_t len(1u); len < n; len *= 2u)
+    {
+      const uint32_t* const w = inv_roots.data() + len;
+      for (size_t i(0); i < n; i += 2u * len)
+      {
+        uint32_t* const lo = a + i;
+        uint32_t* const hi = lo + len;
+        for (size_t j(0); j < len; ++j)
+        {
+          const uint32_t u = lo[j];
+          const uint32_t v = f.mul(hi[j], w[j]);
+          lo[j] = f.add(u, v);
+          hi[j] = f.sub(u, v);
+        }
+      }
+    }
+  }
+
+  // t[0..n) = 16-bit pieces of p[0..pn), LS piece first, zero padded
+  static void ntt_split(uint32_t* t, const size_t n, const uint32_t* p, const size_t pn) noexcept
+  {
+    for (size_t i(0); i < pn; ++i)
+    {
+      t[2u * i] = p[i] & 0xffffu;
+      t[2u * i + 1u] = p[i] >> 16u;
+    }
+    std::fill(t + 2u * pn, t + n, 0u);
+  }
+
+  // r[0..rn) = the number whose 16-bit pieces are the convolution coefficients,
+  // given the coefficients modulo each of the ntt_primes.
+  static void ntt_recombine(uint32_t* r, const size_t rn, const vec32 (&residues)[3]) noexcept
+  {
+    const uint64_t p0 = ntt_primes[0].p;
+    const uint64_t p1 = ntt_primes[1].p;
+    const uint64_t p2 = ntt_primes[2].p;
+    const uint64_t p0p1 = p0 * p1;   // < 2**60
+    const Ntt_field f1(ntt_primes[1].p);
+    const Ntt_field f2(ntt_primes[2].p);
+    // Garner's constants, in Montgomery form, so that multiplying by them is an
+    // ordinary product.  Ntt_field::mul accepts an unreduced factor below 2**31.
+    const uint32_t inv_p0 = f1.to_montgomery(f1.pow_mod(uint32_t(p0 % p1), uint32_t(p1) - 2u));   // 1/p0 mod p1
+    const uint32_t inv_p0p1 = f2.pow_mod(uint32_t(p0p1 % p2), uint32_t(p2) - 2u);                  // 1/(p0*p1) mod p2
+    const uint32_t c2 = f2.to_montgomery(inv_p0p1);
+    const uint32_t c2_p0 = f2.to_montgomery(f2.mul_mod(inv_p0p1, uint32_t(p0 % p2)));
+
+    // the running sum, as a 128-bit number
+    uint64_t acc_lo(0u);
+    uint64_t acc_hi(0u);
+    const size_t num_pieces = 2u * rn;
+    const size_t num_coefficients = std::min(residues[0].size(), num_pieces);
+    for (size_t k(0); k < num_pieces; ++k)
+    {
+      if (k < num_coefficients)
+      {
+        // Garner: x = r0 + p0*t1 + p0*p1*t2, where
+        //   t1 = (r1 - r0)/p0 mod p1,  t2 = (r2 - r0 - p0*t1)/(p0*p1) mod p2
+        const uint32_t r0 = residues[0][k];
+        const uint32_t r1 = residues[1][k];
+        const uint32_t r2 = residues[2][k];
+        const uint32_t t1 = f1.sub(f1.mul(r1, inv_p0), f1.mul(r0, inv_p0));
+        const uint64_t v = r0 + p0 * t1;  // < p0*p1
+        const uint64_t t2 = f2.sub(f2.sub(f2.mul(r2, c2), f2.mul(r0, c2)), f2.mul(t1, c2_p0));
+
+        // acc += v + p0p1*t2, where p0p1*t2 is split into 32-bit halves of p0p1
+        const uint64_t lo = (p0p1 & 0xffff'ffffu) * t2;
+        const uint64_t hi = (p0p1 >> 32u) * t2;
+        uint64_t sum = acc_lo + lo;
+        acc_hi += (sum < lo) ? 1u : 0u;
+        const uint64_t hi_shifted = hi << 32u;
+        acc_lo = sum + hi_shifted;
+        acc_hi += (acc_lo < hi_shifted) ? 1u : 0u;
+        acc_hi += hi >> 32u;
+        sum = acc_lo + v;
+        acc_hi += (sum < v) ? 1u : 0u;
+        acc_lo = sum;
+      }
+      const uint32_t piece = uint32_t(acc_lo & 0xffffu);
+      if (k & 1u)
+      {
+        r[k / 2u] |= piece << 16u;
+      }
+      else
+      {
+        r[k / 2u] = piece;
+      }
+      acc_lo = (acc_lo >> 16u) | (acc_hi << 48u);
+      acc_hi >>= 16u;
+    }
+#ifdef _DEBUG
+    assert((acc_lo == 0u) and (acc_hi == 0u));
+#endif
+  }
+
+  // r[0..an+bn) = a[0..an) * b[0..bn) using NTTs.
+  // precondition: 0 < an <= bn, an + bn <= NTT_MAX_WORDS
+  // A square (a and b the same range) needs only one forward transform per prime.
+  static void mul_NTT_n(uint32_t* r, const uint32_t* a, const size_t an, const uint32_t* b, const size_t bn)
+  {
+    const bool is_square = (a == b) && (an == bn);
+    const size_t num_pieces = 2u * (an + bn);   // an upper bound for the pieces in the product
+    size_t n(1u);
+    while (n < num_pieces - 1u)
+    {
+      n *= 2u;
+    }
+
+    // the convolution modulo each prime
+    vec32 residues[3];
+    vec32 tb(is_square ? 0u : n);
+    for (size_t k(0); k < 3u; ++k)
+    {
+      const Ntt_field f(ntt_primes[k].p);
+      const uint32_t p = f.prime();
+      const uint32_t w = f.pow_mod(ntt_primes[k].generator, (p - 1u) / n);  // primitive n-th root of unity
+      const uint32_t w_inv = f.pow_mod(w, n - 1u);
+
+      vec32& ta = residues[k];
+      ta.resize(n);
+      ntt_split(ta.data(), n, a, an);
+      {
+        const vec32 roots = ntt_roots(f, w, n);
+        ntt_forward(ta.data(), n, roots, f);
+        if (not is_square)
+        {
+          ntt_split(tb.data(), n, b, bn);
+          ntt_forward(tb.data(), n, roots, f);
+        }
+      }
+      // The pointwise product mul(ta,tb) is ta*tb/2**32, so scale it by 2**32/n,
+      // which also takes care of the factor n from the inverse transform.
+      const uint32_t n_inv = f.pow_mod(uint32_t(n % p), p - 2u);
+      const uint32_t scale = f.to_montgomery(f.mul_mod(n_inv, f.to_montgomery(1u)));
+      const uint32_t* const tb_or_ta = is_square ? ta.data() : tb.data();
+      for (size_t i(0); i < n; ++i)
+      {
+        ta[i] = f.mul(f.mul(ta[i], tb_or_ta[i]), scale);
+      }
+      ntt_inverse(ta.data(), n, ntt_roots(f, w_inv, n), f);
+    }
+
+    ntt_recombine(r, an + bn, residues);
+  }
+
+  // div, divide n by d, returning a quotient and a remainder
+  // satisfies n = quot * d + rem,   where rem < d, unless d==0, in which case rem=d=0
+  // This is the old long division, see div_vec32 for the one in use.
+  std::pair< std::vector<uint32_t>, std::vector<uint32_t> > div_old_fashioned(const std::vector<uint32_t>& n, const std::vector<uint32_t>& d)
+  {
+    std::pair<vec32, vec32> result;
+    const bool is_zero_quotient = less_than(n, d);
+    const size_t nsize = n.size();
+    const size_t dsize = d.size();
+
+    if (dsize == 1)
+    {
+      // special case of 1-word divisor. Also handles divide-by-zero case.
+      std::pair<vec32, uint32_t> temp = div(n, d[0]);
+      result.first = temp.first;
+      if (temp.second != 0u)
+      {
+        result.second = vec32(1, temp.second);  // a zero remainder is the empty vector
+      }
+#ifdef _DEBUG
+      assert(loop_invariant(n, d, result.first, result.second));
+#endif
+      return result;
+    }
+
+    const size_t quotient_num_words = is_zero_quotient ? size_t(1u) : (nsize - dsize + 1u);
+    const size_t remainder_num_words = test_zero(d) ? 1u : (is_zero_quotient ? nsize : dsize);
+
+    // allocate memory for the returned quotient, zero filling it.
+    // It might be 1 word too large and may need a pop_back to preserve the invariant (quotient.back() != 0u)
+    result.first = vec32(quotient_num_words, 0u);
+    result.second = vec32(remainder_num_words, 0u);
+
+    if (test_nonzero(d))
+    {
+      // some more meaningful names
+      vec32& ret_quotient = result.first;
+      vec32& ret_remainder = result.second;
+
+      ret_remainder = n;   // copy the numerator
+
+                 // at this point, have established the invariant
+                 // n = quotient*d + remainder; 
+                 // underestimate the quotient and keep subtracting until remainder < d
+      size_t rsize = ret_remainder.size();
+      const uint32_t d_MSW = d.back();  // get the MSW of the divisor
+      const uint64_t d_MSDW = (uint64_t(d_MSW) << 32u) + d[dsize - 2];
+#ifdef _DEBUG
+      assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+      //size_t loopcount(0);
+      while (not less_than(ret_remainder, d))   // ensures the (remainder < d) postcondition, same as while r>=d
+      {
+        //++loopcount;
+#ifdef _DEBUG
+        assert(rsize >= dsize);  // r >=d implies rsize >= dsize >= 2
+#endif
+                     // since the smallest rsize can be is two, that is the base case
+                     // for exiting the loop.  Otherwise keep reducing remainder.
+        if (ret_remainder.size() == 2u)   // A base case for exiting loop
+        {
+          // can do this last step exactly.
+          const uint64_t rem_dword = (uint64_t(ret_remainder[1u]) << 32u) + ret_remainder[0];
+          const uint64_t quot_dword = rem_dword / d_MSDW;
+          // since d_MSDW is nonzero in MSW, this quotient really fits in 32 bits.
+          const uint32_t quot_word = uint32_t(quot_dword);
+          const uint64_t prod_dword = quot_dword * d_MSDW;
+          increment_by_word(ret_quotient, quot_word);  // increase the quotient
+          subtract_dword_from_MSDW(ret_remainder, prod_dword);  // decrease the remainder
+#ifdef _DEBUG
+          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+          break;  //out of loop
+        }
+
+        const uint64_t rem_MSWs = (uint64_t(ret_remainder[rsize - 1u]) << 32) + uint64_t(ret_remainder[rsize - 2u]);
+
+        if (d_MSDW < rem_MSWs)
+        {
+          // can use (d_MSDW+1) for trial divide, it will give at least a quotient 1.
+          // The +1 accounts for the lower words of d, so the quotient is never too big,
+          // and since rem_MSWs > d_MSDW it cannot overflow.
+          // because the MSW of div_word is nonzero, this results in a single-word quotient
+          const uint64_t high_quotd = rem_MSWs / (d_MSDW + 1u);
+#ifdef _DEBUG
+          assert(high_quotd < 0x1'0000'0000ull);
+#endif
+          const uint32_t high_quotw = uint32_t(high_quotd);
+          const size_t index_of_work(rsize - dsize);  // note rsize>=dsize since remainder >=d
+          sub_product_at_index(ret_remainder, index_of_work, d, high_quotw);
+          increment_at_index_by_word(ret_quotient, index_of_work, high_quotw);  // increase the (quotient*d) value
+#ifdef _DEBUG
+          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+        }
+        else if (d_MSDW == rem_MSWs)
+        {
+          if (rsize == dsize)
+          {
+            // r is nearly equal to d, just subtract d from r and exit
+            decrement_by(ret_remainder, d);
+            const uint32_t one(1u);
+            increment_by_word(ret_quotient, one);  // increase the (quotient*d) value
+#ifdef _DEBUG
+            assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+            assert(less_than(ret_remainder, d));
+#endif
+            break;
+          }
+
+          // quotient is darn nearly 1. use 0xffffffff as an estimated quotient, with a word shift (see index_of_work)
+#ifdef _DEBUG
+          assert(rsize > dsize);  // Since already handled rsize == dsize, it must be rsize > dsize.
+#endif
+          const size_t index_of_work = rsize - dsize - 1u;  // ok since rsize > dsize
+          const uint32_t quot_w = 0xffff'ffffu;
+          // proof that quotient is not too big:
+          // Need to verify that r >= q*d
+          // Since r and d have equal MSWs, this inequality holds:
+          // r + 2**32(rs-2) > d * 2**32(rs-ds)  where rs=rsize, ds = dsize.
+          // rearranging gives
+          // r > d*(2**32(rs-ds)-k) + (k*d - 2**32(rs-2))   where choose k=2**32(rs-ds-1)
+          // the last term is >=0 because d>=2**32(ds-1)  (the MSW of d is >=1)
+          // dropping the (non-negative) last term gives
+          // r > d*(2**32(rs-ds)-2**32(rs-ds-1))
+          // r > d*q  where q = 0xffffffff * 2**32(rs-ds-1)
+          // QED
+
+
+          // ret_remainder -= word_shift( d*high_quotw, index_of_work)
+          sub_product_at_index(ret_remainder, index_of_work, d, quot_w);
+          //const vec32 product = mul_vec32_by_word(d, quot_w);
+          //decrement_at_index(ret_remainder, index_of_work, product);  // decrement remainder by product at index
+
+          increment_at_index_by_word(ret_quotient, index_of_work, quot_w);  // increase the (quotient*d) value
+#ifdef _DEBUG
+          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+        }
+        else
+        {
+          // can use (d_MSW+1) for trial divide
+          // proof that the quotient obtained fits in 32 bits:
+          // since here,  d_MSDW > rem_MSWs
+          // so           d_MSW*2**32 >= rem_MSWs
+          //              (d_MSW+1)*2**32 > rem_MSWs
+          // or           2**32 > rem_MSWs/(d_MSW+1)
+          // QED
+          const uint64_t high_quotd = rem_MSWs / (uint64_t(d_MSW) + 1u);
+#ifdef _DEBUG
+          assert(high_quotd < 0x1'0000'0000ull);
+#endif
+          const uint32_t high_quotw = uint32_t(high_quotd);
+#ifdef _DEBUG
+          assert(high_quotw != 0);
+#endif
+          const size_t index_of_work = rsize - dsize - 1u;
+
+          // ret_remainder -= word_shift( d*high_quotw, index_of_work)
+          sub_product_at_index(ret_remainder, index_of_work, d, high_quotw);
+          //const vec32 product = mul_vec32_by_word(d, high_quotw);
+          //decrement_at_index(ret_remainder, index_of_work, product);  // decrement remainder by product at index
+          increment_at_index_by_word(ret_quotient, index_of_work, high_quotw);  // increase the (quotient*d) value
+#ifdef _DEBUG
+          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+        }
+        rsize = ret_remainder.size();
+
+      } // while
+
+        // remove any 0 MSWs left in the quotient
+      while ((ret_quotient.size() != 0) && (ret_quotient.back() == 0))
+      {
+        ret_quotient.pop_back();
+      }
+#ifdef _DEBUG
+      assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+#endif
+      //std::cout << " loopcount=" << loopcount << " sizeof n=" << nsize << " sizeof d=" << dsize << std::endl;
+
+
+    }  // endif nonzero divisor
+    return result;
+  }
+
+
+
+  // precondition: b.size() >= a.size()
+  // postcondition:  b is modified to (a*b)
+  void mul_ordered_in_place(const vec32& a, vec32& b)
+  {
+    if (1u == a.size())
+    {
+      scale_by_word(b, a[0]);
+    }
+    else
+    {
+      vec32 result = mul_ordered(a, b);
+      b = result;  // replace contents!
+    }
+  }
+
+
+  // r[0..n) -= a[0..n) * w, returns the word borrowed out of r[n-1].
+  static uint32_t submul_1(uint32_t* r, const uint32_t* a, const size_t n, const uint32_t w) noexcept
+  {
+    const uint64_t ww(w);
+    uint64_t borrow(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint64_t t = uint64_t(a[i]) * ww + borrow;
+      const uint32_t lo = uint32_t(t);
+      const uint32_t ri = r[i];
+      r[i] = ri - lo;
+      borrow = (t >> 32u) + (ri < lo);
+    }
+    return uint32_t(borrow);
+  }
+
+  // r[0..n) = a[0..n) << shift, returns the bits shifted out.  0 <= shift < 32
+  static uint32_t lshift_n(uint32_t* r, const uint32_t* a, const size_t n, const unsigned shift) noexcept
+  {
+    if (shift == 0u)
+    {
+      std::copy(a, a + n, r);
+      return 0u;
+    }
+    uint32_t out(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint32_t ai = a[i];
+      r[i] = (ai << shift) | out;
+      out = ai >> (32u - shift);
+    }
+    return out;
+  }
+
+  // r[0..n) = a[0..n) >> shift, where the bits shifted out are zero.  0 <= shift < 32
+  static void rshift_n(uint32_t* r, const uint32_t* a, const size_t n, const unsigned shift) noexcept
+  {
+    if (shift == 0u)
+    {
+      std::copy(a, a + n, r);
+      return;
+    }
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint32_t above = (i + 1u < n) ? a[i + 1u] : 0u;
+      r[i] = (a[i] >> shift) | (above << (32u - shift));
+    }
+  }
+
+  // size of the range p[0..n) without its MSW zeros
+  static size_t normalized_size(const uint32_t* p, size_t n) noexcept
+  {
+    while ((n != 0u) && (p[n - 1u] == 0u))
+    {
+      --n;
+    }
+    return n;
+  }
+
+  // Knuth's Algorithm D (The Art of Computer Programming, vol 2, 4.3.1).
+  // q[0..un-dn) = u[0..un) / v[0..dn), and the remainder is left in u[0..dn).
+  // precondition: dn >= 2, un > dn, the MSW of v has its top bit set,
+  //               and u[un-dn..un) < v, so each quotient word fits in a word.
+  // Each quotient word is estimated from the top two words of the remainder and the
+  // top word of v, corrected at most twice using the second word of v, and then at
+  // most once more after the multiply-subtract.
+  static void divrem_basecase(uint32_t* q, uint32_t* u, const size_t un, const uint32_t* v, const size_t dn) noexcept
+  {
+    const uint64_t v1 = v[dn - 1u];
+    const uint64_t v2 = v[dn - 2u];
+    for (size_t j(un - dn); j != 0u; )
+    {
+      --j;
+      uint32_t* const uj = u + j;
+      const uint64_t top = (uint64_t(uj[dn]) << 32u) | uj[dn - 1u];
+      uint64_t qhat = top / v1;
+      uint64_t rhat = top % v1;
+      while ((qhat > 0xffff'ffffu) || (qhat * v2 > ((rhat << 32u) | uj[dn - 2u])))
+      {
+        --qhat;
+        rhat += v1;
+        if (rhat > 0xffff'ffffu)
+        {
+          break;
+        }
+      }
+
+      const uint32_t borrow = submul_1(uj, v, dn, uint32_t(qhat));
+      const uint32_t top_word = uj[dn];
+      uj[dn] = top_word - borrow;
+      if (top_word < borrow)
+      {
+        // qhat was one too large, add v back
+        --qhat;
+        uj[dn] += add_n(uj, uj, v, dn);
+      }
+      q[j] = uint32_t(qhat);
+    }
+  }
+
+  // true if a[0..n) >= b[0..n)
+  static bool greater_equal_n(const uint32_t* a, const uint32_t* b, size_t n) noexcept
+  {
+    while (n != 0u)
+    {
+      --n;
+      if (a[n] != b[n])
+      {
+        return a[n] > b[n];
+      }
+    }
+    return true;
+  }
+
+  // Number of words of scratch needed by divrem_dc_n for a divisor of size at most n.
+  static size_t divrem_dc_scratch_size(size_t n) noexcept
+  {
+    // each level keeps an n word product, and karatsuba_scratch_size(n) covers
+    // the multiplies of every level.
+    size_t words = karatsuba_scratch_size(n);
+    while (n >= BURNIKEL_ZIEGLER_THRESHOLD)
+    {
+      words += n;
+      n -= n / 2u;
+    }
+    return words;
+  }
+
+  // Burnikel-Ziegler recursive division (in the form of GMP's dcpi1_div_qr_n).
+  // q[0..n) = u[0..2n) / v[0..n), returns the quotient bit q[n] (0 or 1),
+  // and leaves the remainder in u[0..n).
+  // precondition: n >= 2, and the MSW of v has its top bit set.
+  //
+  // The top hi words of the quotient are found by dividing the top 2*hi words of u
+  // by the top hi words of v.  Since v is normalized, that is at most 2 too large,
+  // so subtracting its product with the low lo words of v needs at most 2 corrections.
+  // Then the same for the low lo words of the quotient.  The cost is 2 half size
+  // divisions and 2 half size multiplies, so a small multiple of mul_vec32.
+  // scratch: divrem_dc_scratch_size(n) words.
+  static uint32_t divrem_dc_n(uint32_t* q, uint32_t* u, const uint32_t* v, const size_t n, uint32_t* scratch)
+  {
+    const uint32_t one(1u);
+    if (n < BURNIKEL_ZIEGLER_THRESHOLD)
+    {
+      const uint32_t qh = greater_equal_n(u + n, v, n) ? 1u : 0u;
+      if (qh != 0u)
+      {
+        sub_n(u + n, u + n, v, n);
+      }
+      divrem_basecase(q, u, 2u * n, v, n);
+      return qh;
+    }
+
+    const size_t lo = n / 2u;
+    const size_t hi = n - lo;
+    uint32_t* const product = scratch;  // n words
+    uint32_t* const next_scratch = scratch + n;
+
+    // q[lo..n) from u[2*lo..2n) / v[lo..n), the remainder is u[0..n+lo)
+    uint32_t qh = divrem_dc_n(q + lo, u + 2u * lo, v + lo, hi, next_scratch);
+    mul_dispatch(product, v, lo, q + lo, hi, next_scratch);
+    uint32_t borrow = sub_n(u + lo, u + lo, product, n);
+    if (qh != 0u)
+    {
+      borrow += sub_n(u + n, u + n, v, lo);
+    }
+    while (borrow != 0u)
+    {
+      qh -= sub_in_place(q + lo, hi, &one, 1u);
+      borrow -= add_n(u + lo, u + lo, v, n);
+    }
+
+    // q[0..lo) from u[hi..n+lo) / v[hi..n), the remainder is u[0..n)
+    const uint32_t ql = divrem_dc_n(q, u + hi, v + hi, lo, next_scratch);
+    mul_dispatch(product, q, lo, v, hi, next_scratch);
+    borrow = sub_n(u, u, product, n);
+    if (ql != 0u)
+    {
+      borrow += sub_n(u + lo, u + lo, v, hi);
+    }
+    while (borrow != 0u)
+    {
+      sub_in_place(q, lo, &one, 1u);
+      borrow -= add_n(u, u, v, n);
+    }
+    return qh;
+  }
+
+  // true if div_vec32 uses divrem_dc for a numerator and divisor of these sizes
+  static bool use_Burnikel_Ziegler(const size_t nsize, const size_t dsize) noexcept
+  {
+    return (dsize >= BURNIKEL_ZIEGLER_THRESHOLD) and (nsize + 1u - dsize >= BURNIKEL_ZIEGLER_THRESHOLD);
+  }
+
+  // q[0..un-dn) = u[0..un) / v[0..dn), and the remainder is left in u[0..dn).
+  // Same precondition as divrem_basecase, and dn >= BURNIKEL_ZIEGLER_THRESHOLD.
+  // The quotient is found from the top in blocks of dn words, each one a divrem_dc_n,
+  // after a first shorter block if dn does not divide un-dn.
+  // scratch: dn + divrem_dc_scratch_size(dn) words.
+  static void divrem_dc(uint32_t* q, uint32_t* u, const size_t un, const uint32_t* v, const size_t dn, uint32_t* scratch)
+  {
+    const uint32_t one(1u);
+    size_t qn = un - dn;  // quotient words left to find, the remainder so far is u[0..qn+dn)
+    const size_t k = qn % dn;
+    if (k != 0u)
+    {
+      uint32_t* const uk = u + (qn - k);
+      uint32_t* const qk = q + (qn - k);
+      if (k < BURNIKEL_ZIEGLER_THRESHOLD)
+      {
+        divrem_basecase(qk, uk, dn + k, v, dn);
+      }
+      else
+      {
+        // divide the top 2k words by the top k words of v, then correct as in divrem_dc_n
+        uint32_t* const product = scratch;  // dn words
+        uint32_t* const next_scratch = scratch + dn;
+        uint32_t qh = divrem_dc_n(qk, uk + (dn - k), v + (dn - k), k, next_scratch);
+        if (k <= dn - k)
+        {
+          mul_dispatch(product, qk, k, v, dn - k, next_scratch);
+        }
+        else
+        {
+          mul_dispatch(product, v, dn - k, qk, k, next_scratch);
+        }
+        uint32_t borrow = sub_n(uk, uk, product, dn);
+        if (qh != 0u)
+        {
+          borrow += sub_n(uk + k, uk + k, v, dn - k);
+        }
+        while (borrow != 0u)
+        {
+          qh -= sub_in_place(qk, k, &one, 1u);
+          borrow -= add_n(uk, uk, v, dn);
+        }
+      }
+      qn -= k;
+    }
+
+    while (qn != 0u)
+    {
+      qn -= dn;
+      divrem_dc_n(q + qn, u + qn, v, dn, scratch);
+    }
+  }
+
+  // floor(B**2m / v), where B = 2**32, for a normalized v (MSW top bit set) of m words.
+  // The result has m+1 words.  Starting from the reciprocal of the top half of v,
+  // which has about half of the words right, one step of Newton's iteration
+  //   x' = x + x*(B**2m - v*x) / B**2m
+  // gives nearly all of them, and a few additions or subtractions make it exact.
+  static vec32 reciprocal_vec32(const vec32& v)
+  {
+    const size_t m = v.size();
+    vec32 power(2u * m, 0u);  // B**2m
+    power.push_back(1u);
+    if (m < 2u * BURNIKEL_ZIEGLER_THRESHOLD)
+    {
+      return div_vec32(power, v).first;
+    }
+
+    const size_t h = m - m / 2u;
+    const vec32 x = reciprocal_vec32(vec32(v.end() - h, v.end()));
+    vec32 inverse(m - h, 0u);  // x * B**(m-h)
+    inverse.insert(inverse.end(), x.begin(), x.end());
+
+    // Newton step, the error is (B**2m - v*x), with the sign in .second
+    const std::pair<vec32, bool> error = symdiff_vec32(power, mul_vec32(v, inverse));
+    const vec32 product = mul_vec32(inverse, error.first);
+    if (product.size() > 2u * m)
+    {
+      const vec32 correction(product.begin() + 2u * m, product.end());
+      if (error.second)
+      {
+        inverse = add_vec32(inverse, correction);
+      }
+      else
+      {
+        decrement_by(inverse, correction);
+      }
+    }
+
+    // make it exact, so 0 <= B**2m - v*inverse < v
+    std::pair<vec32, bool> remainder = symdiff_vec32(power, mul_vec32(v, inverse));
+    while ((not remainder.second) and test_nonzero(remainder.first))
+    {
+      decrement_by_word(inverse, 1u);
+      remainder = symdiff_vec32(v, remainder.first);
+    }
+    while (not less_than(remainder.first, v))
+    {
+      increment_by_word(inverse, 1u);
+      decrement_by(remainder.first, v);
+    }
+    return inverse;
+  }
+
+  // Number of words of scratch needed by divrem_reciprocal_n.
+  static size_t divrem_reciprocal_scratch_size(const size_t m) noexcept
+  {
+    return (2u * m + 2u) + 2u * m + karatsuba_scratch_size(m + 1u);
+  }
+
+  // Barrett's division by a precomputed reciprocal.
+  // q[0..k) = u[0..m+k) / v[0..m), and the remainder is left in u[0..m).
+  // precondition: 0 < k <= m, v is normalized, inverse is reciprocal_vec32(v) (m+1 words),
+  //               and u[k..m+k) < v, so the quotient fits in k words.
+  // For k = m, the estimate floor(floor(u / B**(m-1)) * inverse / B**(m+1)) is at most
+  // 2 too small (Handbook of Applied Cryptography, 14.42).  For k < m only the top k+1
+  // words of inverse are used, which can make it 1 smaller.  So after subtracting the
+  // product of the estimate and v, at most 3 more subtractions are needed.
+  static void divrem_reciprocal_n(uint32_t* q, uint32_t* u, const size_t k, const uint32_t* v, const uint32_t* inverse,
+                                  const size_t m, uint32_t* scratch)
+  {
+    uint32_t* const estimate = scratch;  // 2k+2 words
+    uint32_t* const product = scratch + (2u * m + 2u);  // m+k words
+    uint32_t* const next_scratch = product + 2u * m;
+    mul_dispatch(estimate, u + (m - 1u), k + 1u, inverse + (m - k), k + 1u, next_scratch);
+    std::copy(estimate + (k + 1u), estimate + (2u * k + 1u), q);  // estimate[2k+1] is 0
+
+    // the remainder is less than 4v, so fits in m+1 words
+    mul_dispatch(product, q, k, v, m, next_scratch);
+    sub_n(u, u, product, m + 1u);
+    const uint32_t one(1u);
+    while ((u[m] != 0u) or greater_equal_n(u, v, m))
+    {
+      u[m] -= sub_n(u, u, v, m);
+      add_in_place(q, k, &one, 1u);
+    }
+  }
+
+  size_t add_vec32(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn) noexcept
+  {
+    if (an < bn)
+    {
+      std::swap(a, b);
+      std::swap(an, bn);
+    }
+    std::copy(a, a + an, r);
+    r[an] = add_in_place(r, an, b, bn);
+    return an + r[an];
+  }
+
+  size_t mul_scratch_size(const size_t asize, const size_t bsize) noexcept
+  {
+    return karatsuba_scratch_size(std::min(std::max(asize, bsize), 2u * std::min(asize, bsize)));
+  }
+
+  size_t mul_vec32(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn, Workspace& ws)
+  {
+    if ((an == 0u) || (bn == 0u))
+    {
+      return 0u;
+    }
+    if (an > bn)
+    {
+      std::swap(a, b);
+      std::swap(an, bn);
+    }
+    mul_dispatch(r, a, an, b, bn, ws.reserve(mul_scratch_size(an, bn)));
+    return normalized_size(r, an + bn);
+  }
+
+  size_t sqr_scratch_size(const size_t n) noexcept
+  {
+    return karatsuba_scratch_size(n);
+  }
+
+  size_t sqr_vec32(uint32_t* r, const uint32_t* a, const size_t n, Workspace& ws)
+  {
+    if (n == 0u)
+    {
+      return 0u;
+    }
+    sqr_dispatch(r, a, n, ws.reserve(sqr_scratch_size(n)));
+    return normalized_size(r, 2u * n);
+  }
+
+  size_t div_scratch_size(const size_t nsize, const size_t dsize) noexcept
+  {
+    // the normalized numerator, with an extra word, and the normalized divisor
+    if ((dsize < 2u) || (nsize < dsize))
+    {
+      return 0u;
+    }
+    const size_t words = nsize + 1u + dsize;
+    return use_Burnikel_Ziegler(nsize, dsize) ? words + dsize + divrem_dc_scratch_size(dsize) : words;
+  }
+
+  // The span div_vec32, with scratch of div_scratch_size(nn, dn) words.
+  // When nn >= dn, n is read before r is written, so r may be the same as n.
+  static std::pair<size_t, size_t> divrem_n(uint32_t* q, uint32_t* r, const uint32_t* n, const size_t nn,
+                                            const uint32_t* d, const size_t dn, uint32_t* scratch)
+  {
+    if (dn == 0u)
+    {
+      return std::pair<size_t, size_t>(0u, 0u);  // as div_vec32, divide by 0 gives (0,0)
+    }
+    if (nn < dn)
+    {
+      std::copy(n, n + nn, r);
+      return std::pair<size_t, size_t>(0u, nn);
+    }
+
+    const size_t qn = nn - dn + 1u;
+    if (dn == 1u)
+    {
+      r[0] = Word_divisor(d[0]).divrem(q, n, nn);
+      return std::pair<size_t, size_t>(normalized_size(q, qn), (r[0] != 0u) ? 1u : 0u);
+    }
+
+    // normalize, so the top bit of the divisor is set
+    uint32_t* const u = scratch;
+    uint32_t* const v = u + (nn + 1u);
+    const unsigned shift = leading_zeros(d[dn - 1u]);
+    lshift_n(v, d, dn, shift);
+    u[nn] = lshift_n(u, n, nn, shift);
+
+    if (use_Burnikel_Ziegler(nn, dn))
+    {
+      divrem_dc(q, u, nn + 1u, v, dn, v + dn);
+    }
+    else
+    {
+      divrem_basecase(q, u, nn + 1u, v, dn);
+    }
+    rshift_n(r, u, dn, shift);
+    return std::pair<size_t, size_t>(normalized_size(q, qn), normalized_size(r, dn));
+  }
+
+  // q[0..qn) = r / d[0..dn) mod 2**(32*qn), which is the quotient when d divides r
+  // and the quotient fits in qn words.  r is overwritten.
+  // precondition: d[0] is odd, r has at least qn words.
+  // Like divexact_1, but each quotient word is subtracted with a whole row of d.
+  static void divexact_n(uint32_t* q, uint32_t* r, const size_t qn, const uint32_t* d, const size_t dn) noexcept
+  {
+    const uint32_t inverse = inverse_mod_word(d[0]);
+    for (size_t i(0); i < qn; ++i)
+    {
+      const uint32_t qi = r[i] * inverse;
+      q[i] = qi;
+      const size_t len = std::min(dn, qn - i);
+      const uint32_t borrow = submul_1(r + i, d, len, qi);
+      if (i + len < qn)
+      {
+        sub_in_place(r + i + len, qn - i - len, &borrow, 1u);
+      }
+    }
+  }
+
+  std::pair<size_t, size_t> div_vec32(uint32_t* q, uint32_t* r, const uint32_t* n, const size_t nn,
+                                      const uint32_t* d, const size_t dn, Workspace& ws)
+  {
+    return divrem_n(q, r, n, nn, d, dn, ws.reserve(div_scratch_size(nn, dn)));
+  }
+
+  uint32_t divrem_inplace(std::vector<uint32_t>& n, const uint32_t d)
+  {
+    if ((d == 0u) || n.empty())
+    {
+      n.clear();
+      return 0u;
+    }
+    const uint32_t remainder = Word_divisor(d).divrem(n.data(), n.data(), n.size());
+    if (n.back() == 0u)
+    {
+      n.pop_back();
+    }
+    return remainder;
+  }
+
+  void divrem_inplace(std::vector<uint32_t>& n, const std::vector<uint32_t>& d, std::vector<uint32_t>& q, Workspace& ws)
+  {
+    const size_t nsize = n.size();
+    const size_t dsize = d.size();
+    if (dsize == 0u)
+    {
+      n.clear();  // divide by zero
+      q.clear();
+      return;
+    }
+    if (nsize < dsize)
+    {
+      q.clear();  // n is already the remainder
+      return;
+    }
+    q.resize(nsize - dsize + 1u);
+    const std::pair<size_t, size_t> sizes = divrem_n(q.data(), n.data(), n.data(), nsize, d.data(), dsize,
+                                                     ws.reserve(div_scratch_size(nsize, dsize)));
+    q.resize(sizes.first);
+    n.resize(sizes.second);
+  }
+
+  // div, divide n by d, returning a quotient and a remainder
+  // satisfies n = quot * d + rem,   where rem < d, unless d==0, in which case rem=d=0
+  std::pair< std::vector<uint32_t>, std::vector<uint32_t> > div_vec32(const std::vector<uint32_t>& n, const std::vector<uint32_t>& d)
+  {
+    std::pair<vec32, vec32> result;
+    const size_t nsize = n.size();
+    const size_t dsize = d.size();
+    if (dsize == 0u)
+    {
+      return result;  // divide by zero
+    }
+    if (nsize < dsize)
+    {
+      result.second = n;
+      return result;
+    }
+
+    result.first.resize(nsize - dsize + 1u);
+    result.second.resize(dsize);
+    Workspace ws(div_scratch_size(nsize, dsize));
+    const std::pair<size_t, size_t> sizes = div_vec32(result.first.data(), result.second.data(), n.data(), nsize, d.data(), dsize, ws);
+    result.first.resize(sizes.first);
+    result.second.resize(sizes.second);
+#ifdef _DEBUG
+    assert(loop_invariant(n, d, result.first, result.second));
+#endif
+    return result;
+  }
+
+  Nat mul(const Nat& a, const Nat& b)
+  {
+    // calculate convolution sum a[i]*b[j] for i+j = pos
+    // the value goes in the "pos" position.
+    // pos runs from 0 to a.size()+b.size()-2.
+    // example ab*de = be at pos=0, ad+be at pos=1, ad at pos=2
+
+    return Nat(mul_vec32(a.num.d, b.num.d));
+  }
+
+  // a += b in place, like increment_by_word: a grows only for the carry out of its MSW
+  static void increment_by_vec32(vec32& a, const vec32& b)
+  {
+    if (a.size() < b.size())
+    {
+      a.resize(b.size(), 0u);
+    }
+    const uint32_t carry = add_in_place(a.data(), a.size(), b.data(), b.size());
+    if (carry != 0u)
+    {
+      a.push_back(carry);
+    }
+  }
+
+  // a -= b in place, for a >= b
+  static void decrement_by_vec32(vec32& a, const vec32& b) noexcept
+  {
+    sub_in_place(a.data(), a.size(), b.data(), b.size());
+    remove_MSW_zeros(a);
+  }
+
+  // a = b - a in place, for a <= b
+  static void subtract_from_vec32(vec32& a, const vec32& b)
+  {
+    a.resize(b.size(), 0u);
+    sub_n(a.data(), b.data(), a.data(), b.size());
+    remove_MSW_zeros(a);
+  }
+
+  Nat operator+(const Nat& a, const Nat& b)
+  {
+    return add(a, b);
+  }
+
+  Nat operator+(Nat&& a, const Nat& b)
+  {
+    increment_by_vec32(a.num.d, b.num.d);
+    return std::move(a);
+  }
+
+  Nat operator+(const Nat& a, Nat&& b)
+  {
+    return std::move(b) + a;
+  }
+
+  Nat operator+(Nat&& a, Nat&& b)
+  {
+    // the one with more room takes the sum
+    return (a.num.d.capacity() >= b.num.d.capacity()) ? std::move(a) + b : std::move(b) + a;
+  }
+
+  Nat operator-(const Nat& a, const Nat& b)
+  {
+    return less_than(a.num.d, b.num.d) ? Nat() : Nat(symdiff_vec32(a.num.d, b.num.d).first);
+  }
+
+  Nat operator-(Nat&& a, const Nat& b)
+  {
+    if (less_than(a.num.d, b.num.d))
+    {
+      a.num.d.clear();
+    }
+    else
+    {
+      decrement_by_vec32(a.num.d, b.num.d);
+    }
+    return std::move(a);
+  }
+
+  Nat operator-(const Nat& a, Nat&& b)
+  {
+    if (less_than(a.num.d, b.num.d))
+    {
+      b.num.d.clear();
+    }
+    else
+    {
+      subtract_from_vec32(b.num.d, a.num.d);
+    }
+    return std::move(b);
+  }
+
+  Nat operator-(Nat&& a, Nat&& b)
+  {
+    return std::move(a) - b;
+  }
+
+  Nat operator*(const Nat& a, const Nat& b)
+  {
+    return mul(a, b);
+  }
+
+  Nat operator*(Nat&& a, const Nat& b)
+  {
+    if (b.num_word32() > 1u)
+    {
+      return mul(a, b);
+    }
+    scale_by_word(a.num.d, b.is_zero() ? 0u : b.ls_word());
+    return std::move(a);
+  }
+
+  Nat operator*(const Nat& a, Nat&& b)
+  {
+    return std::move(b) * a;
+  }
+
+  Nat operator*(Nat&& a, Nat&& b)
+  {
+    return (b.num_word32() <= 1u) ? std::move(a) * b : std::move(b) * a;
+  }
+
+
+  std::pair<Nat, uint32_t> div(const Nat& n, uint32_t d)
+  {
+    std::pair< vec32, uint32_t > temp = div(n.num.d, d);
+    return std::pair <Nat, uint32_t>(std::move(temp.first), temp.second);
+  }
+
+  std::pair<Nat, uint32_t> div(const Nat& n, const Word_divisor& d)
+  {
+    std::pair< vec32, uint32_t > temp = div(n.num.d, d);
+    return std::pair <Nat, uint32_t>(std::move(temp.first), temp.second);
+  }
+
+  Nat mod(const Nat& n, const Nat& d)
+  {
+    const size_t nsize = n.num_word32();
+    const size_t dsize = d.num_word32();
+    if ((dsize == 0u) || (nsize < dsize))
+    {
+      return (dsize == 0u) ? Nat() : n;
+    }
+    if (dsize == 1u)
+    {
+      return Nat(mod(n, d.ls_word()));
+    }
+    // the unwanted quotient goes in the scratch
+    const size_t qsize = nsize - dsize + 1u;
+    vec32 scratch(qsize + div_scratch_size(nsize, dsize));
+    vec32 remainder(dsize);
+    const std::pair<size_t, size_t> sizes = divrem_n(scratch.data(), remainder.data(), n.num.d.data(), nsize,
+                                                     d.num.d.data(), dsize, scratch.data() + qsize);
+    remainder.resize(sizes.second);
+    return Nat(std::move(remainder));
+  }
+
+  uint32_t mod(const Nat& n, const uint32_t d)
+  {
+    return (d == 0u) ? 0u : Word_divisor(d).mod(n.num.d.data(), n.num_word32());
+  }
+
+  uint32_t mod(const Nat& n, const Word_divisor& d)
+  {
+    return (d.divisor() == 0u) ? 0u : d.mod(n.num.d.data(), n.num_word32());
+  }
+
+  Nat quot(const Nat& n, const Nat& d)
+  {
+    const size_t nsize = n.num_word32();
+    const size_t dsize = d.num_word32();
+    if ((dsize == 0u) || (nsize < dsize))
+    {
+      return Nat();
+    }
+    if (dsize == 1u)
+    {
+      return quot(n, d.ls_word());
+    }
+    // the unwanted remainder goes in the scratch
+    vec32 scratch(dsize + div_scratch_size(nsize, dsize));
+    vec32 quotient(nsize - dsize + 1u);
+    const std::pair<size_t, size_t> sizes = divrem_n(quotient.data(), scratch.data(), n.num.d.data(), nsize,
+                                                     d.num.d.data(), dsize, scratch.data() + dsize);
+    quotient.resize(sizes.first);
+    return Nat(std::move(quotient));
+  }
+
+  Nat operator/(const Nat& n, const Nat& d)
+  {
+    return quot(n, d);
+  }
+
+  Nat operator/(Nat&& n, const Nat& d)
+  {
+    if (d.num_word32() != 1u)
+    {
+      return quot(n, d);
+    }
+    divrem_inplace(n.num.d, d.ls_word());
+    return std::move(n);
+  }
+
+  Nat operator%(const Nat& n, const Nat& d)
+  {
+    return mod(n, d);
+  }
+
+  // n = n % d in the words of n, and 0 if d is 0
+  static void mod_in_place(vec32& n, const vec32& d)
+  {
+    const size_t nsize = n.size();
+    const size_t dsize = d.size();
+    if ((dsize <= 1u) || (nsize < dsize))
+    {
+      if (dsize <= 1u)
+      {
+        const uint32_t r = (dsize == 0u) ? 0u : Word_divisor(d[0]).mod(n.data(), nsize);
+        n.assign((r != 0u) ? 1u : 0u, r);
+      }
+      return;
+    }
+    // the unwanted quotient goes in the scratch
+    const size_t qsize = nsize - dsize + 1u;
+    vec32 scratch(qsize + div_scratch_size(nsize, dsize));
+    const std::pair<size_t, size_t> sizes = divrem_n(scratch.data(), n.data(), n.data(), nsize,
+                                                     d.data(), dsize, scratch.data() + qsize);
+    n.resize(sizes.second);
+  }
+
+  Nat operator%(Nat&& n, const Nat& d)
+  {
+    mod_in_place(n.num.d, d.num.d);
+    return std::move(n);
+  }
+
+  Nat divexact(const Nat& n, const Nat& d)
+  {
+#ifdef _DEBUG
+    assert(d.is_nonzero() and mod(n, d).is_zero());
+#endif
+    const size_t nsize = n.num_word32();
+    const size_t dsize = d.num_word32();
+    if ((dsize == 0u) || (nsize < dsize))
+    {
+      return Nat();
+    }
+    if (dsize == 1u)
+    {
+      return divexact(n, d.ls_word());
+    }
+    if (use_Burnikel_Ziegler(nsize, dsize))
+    {
+      return quot(n, d);  // subquadratic
+    }
+
+    // shift out the trailing zeros of d, which n also has, so the LSW of d is odd
+    const uint32_t* const nw = n.num.d.data();
+    const uint32_t* const dw = d.num.d.data();
+    size_t zero_words(0u);
+    while (dw[zero_words] == 0u)
+    {
+      ++zero_words;
+    }
+    const unsigned shift = trailing_zeros(dw[zero_words]);
+    size_t dn = dsize - zero_words;
+    const size_t an = nsize - zero_words;
+    vec32 work(dn + an);
+    uint32_t* const v = work.data();
+    uint32_t* const r = v + dn;
+    rshift_n(v, dw + zero_words, dn, shift);
+    rshift_n(r, nw + zero_words, an, shift);
+    dn = normalized_size(v, dn);
+
+    vec32 quotient(an - dn + 1u);
+    divexact_n(quotient.data(), r, quotient.size(), v, dn);
+    remove_MSW_zeros(quotient);
+    return Nat(std::move(quotient));
+  }
+
+  Nat divexact(const Nat& n, const uint32_t d)
+  {
+#ifdef _DEBUG
+    assert((d != 0u) and (mod(n, d) == 0u));
+#endif
+    if ((d == 0u) || n.is_zero())
+    {
+      return Nat();
+    }
+    vec32 quotient(n.num.d);
+    divexact_1(quotient.data(), quotient.data(), quotient.size(), d);
+    remove_MSW_zeros(quotient);
+    return Nat(std::move(quotient));
+  }
+
+  bool divisible_by(const Nat& n, const uint32_t d) noexcept
+  {
+    if ((d == 0u) || n.is_zero())
+    {
+      return n.is_zero();
+    }
+    const uint32_t* const a = n.num.d.data();
+    const unsigned shift = trailing_zeros(d);
+    if ((a[0] & ((1u << shift) - 1u)) != 0u)
+    {
+      return false;
+    }
+
+    // The loop of divexact_1 with the odd part of d, which gives
+    //   q*odd = a + borrow * 2**(32*size)
+    // with borrow <= odd.  If odd divides a, then it divides borrow, and borrow = odd
+    // would make q too large, so odd divides a exactly when borrow is 0.
+    const uint32_t odd = d >> shift;
+    const uint32_t inverse = inverse_mod_word(odd);
+    uint32_t borrow(0u);
+    const size_t size = n.num_word32();
+    for (size_t i(0); i < size; ++i)
+    {
+      const uint32_t x = a[i] - borrow;
+      const uint32_t qi = x * inverse;
+      borrow = uint32_t((uint64_t(qi) * odd) >> 32u) + (x > a[i]);
+    }
+    return (borrow == 0u);
+  }
+
+  bool divisible_by(const Nat& n, const Nat& d)
+  {
+    Workspace ws;
+    return divisible_by(n, d, ws);
+  }
+
+  bool divisible_by(const Nat& n, const Nat& d, Workspace& ws)
+  {
+    const size_t nsize = n.num_word32();
+    const size_t dsize = d.num_word32();
+    if ((dsize == 0u) || (nsize < dsize))
+    {
+      return n.is_zero();
+    }
+    if (dsize == 1u)
+    {
+      return divisible_by(n, d.ls_word());
+    }
+    // the quotient and remainder both go in the workspace, which is not reallocated
+    // once it has grown to the largest size
+    const size_t qsize = nsize - dsize + 1u;
+    uint32_t* const q = ws.reserve(qsize + dsize + div_scratch_size(nsize, dsize));
+    uint32_t* const r = q + qsize;
+    return divrem_n(q, r, n.num.d.data(), nsize, d.num.d.data(), dsize, r + dsize).second == 0u;
+  }
+
+  void divisible_by(const Nat& n, const Word_divisor* divisors, const size_t count, bool* results) noexcept
+  {
+    // The remainders are kept shifted, as m_normalized divides n << m_shift.
+    // For a block of divisors, each word of n from the MSW updates every remainder.
+    const size_t BLOCK = 64u;
+    uint32_t remainder[BLOCK];
+    const uint32_t* const a = n.num.d.data();
+    const size_t size = n.num_word32();
+    for (size_t start(0); start < count; start += BLOCK)
+    {
+      const size_t num = std::min(BLOCK, count - start);
+      const Word_divisor* const block = divisors + start;
+      std::fill(remainder, remainder + num, 0u);
+      for (size_t i(size); i != 0u; )
+      {
+        --i;
+        const uint32_t w = a[i];
+        for (size_t j(0); j < num; ++j)
+        {
+          const Word_divisor& d = block[j];
+          if (d.m_normalized == 0u)
+          {
+            continue;  // divide by 0
+          }
+          // (remainder, w) << shift, where the high part does not reach m_normalized
+          const unsigned shift = d.m_shift;
+          const uint32_t high = (shift != 0u) ? (w >> (32u - shift)) : 0u;
+          d.div_2by1(remainder[j] + high, w << shift, remainder[j]);
+        }
+      }
+      for (size_t j(0); j < num; ++j)
+      {
+        results[start + j] = (block[j].m_normalized == 0u) ? n.is_zero() : (remainder[j] == 0u);
+      }
+    }
+  }
+
+  Nat quot(const Nat& n, const uint32_t d)
+  {
+    vec32 quotient(n.num.d);
+    divrem_inplace(quotient, d);
+    return Nat(std::move(quotient));
+  }
+
+  std::pair<Nat, Nat> div(const Nat& n, const Nat& d)
+  {
+    if (d.num.d.size() == 1u)
+    {
+      std::pair< vec32, uint32_t > temp = div(n.num.d, d.num.d[0]);
+      return std::pair <Nat, Nat>(std::move(temp.first), temp.second);
+    }
+    std::pair< vec32, vec32 > temp = div_vec32(n.num.d, d.num.d);
+    return std::pair<Nat, Nat>(std::move(temp.first), std::move(temp.second));
+  }
+
+  Reciprocal::Reciprocal(const Nat& d) : m_divisor(d), m_shift(0u)
+  {
+    const size_t m = d.num_word32();
+    if (m < RECIPROCAL_THRESHOLD)
+    {
+      return;  // div(n, d) is as fast
+    }
+    m_shift = leading_zeros(d.ms_word());
+    m_normalized.resize(m);
+    lshift_n(m_normalized.data(), d.num.d.data(), m, m_shift);
+    m_inverse = reciprocal_vec32(m_normalized);
+  }
+
+  std::pair<Nat, Nat> div(const Nat& n, const Reciprocal& d)
+  {
+    const size_t m = d.m_normalized.size();
+    const size_t nsize = n.num_word32();
+    if ((m == 0u) or (nsize < m))
+    {
+      return div(n, d.m_divisor);
+    }
+
+    // The quotient is found from the top in blocks of m words, each one a
+    // divrem_reciprocal_n, after a first shorter block if m does not divide qsize.
+    const size_t usize = nsize + 1u;
+    const size_t qsize = usize - m;
+    vec32 u(usize + qsize + divrem_reciprocal_scratch_size(m));
+    uint32_t* const q = u.data() + usize;
+    uint32_t* const scratch = q + qsize;
+    u[nsize] = lshift_n(u.data(), n.num.d.data(), nsize, d.m_shift);
+
+    size_t j(qsize);
+    while (j != 0u)
+    {
+      const size_t k = (j % m == 0u) ? m : j % m;
+      j -= k;
+      divrem_reciprocal_n(q + j, u.data() + j, k, d.m_normalized.data(), d.m_inverse.data(), m, scratch);
+    }
+
+    vec32 quotient(q, q + normalized_size(q, qsize));
+    vec32 remainder(m);
+    rshift_n(remainder.data(), u.data(), m, d.m_shift);
+    remainder.resize(normalized_size(remainder.data(), m));
+    return std::pair<Nat, Nat>(std::move(quotient), std::move(remainder));
+  }
+
+
+  Mod_context::Mod_context(const Nat& m) : m_modulus(m), m_inverse(0u)
+  {
+#ifdef _DEBUG
+    assert(m.is_nonzero() and ((m.ls_word() & 1u) != 0u));
+#endif
+    const size_t n = m.num_word32();
+    if (n == 0u)
+    {
+      return;
+    }
+    m_inverse = 0u - inverse_mod_word(m.ls_word());
+    if (n < MONTGOMERY_REDC_N_THRESHOLD)
+    {
+      return;
+    }
+
+    // Newton's iteration for 1/m mod 2**(32*w), doubling w: if m*x = 1 + h*2**(32*w),
+    // then x - h*x*2**(32*w) is the inverse to twice as many words.
+    const uint32_t* const md = m.num.d.data();
+    vec32 x(1u, inverse_mod_word(md[0]));
+    vec32 e(3u * n);
+    vec32 scratch(karatsuba_scratch_size(n));
+    for (size_t w(1); w < n; )
+    {
+      const size_t w2 = std::min(2u * w, n);
+      mul_dispatch(e.data(), x.data(), w, md, w2, scratch.data());
+      const uint32_t* const h = e.data() + w;
+      uint32_t* const hx = e.data() + w2 + w;
+      mul_dispatch(hx, h, w2 - w, x.data(), w, scratch.data());
+      x.resize(w2);
+      neg_n(x.data() + w, hx, w2 - w);
+      w = w2;
+    }
+    m_inverse_n.resize(n);
+    neg_n(m_inverse_n.data(), x.data(), n);
+  }
+
+  size_t Mod_context::scratch_size() const noexcept
+  {
+    // the double length product, then the scratch to make it,
+    // and the two products of the reduction
+    const size_t n = size();
+    const size_t words = 2u * n + karatsuba_scratch_size(n);
+    return m_inverse_n.empty() ? words : words + 4u * n;
+  }
+
+  // r[0..n) = t[0..2n) / R mod m, for t < m*R (Montgomery's REDC).  The sum t + q*m,
+  // with q = t*(-1/m) mod R, is a multiple of R less than 2*m*R.  t is destroyed.
+  // Below MONTGOMERY_REDC_N_THRESHOLD, q is found a word at a time: step i adds
+  // q[i]*m << (32*i) to make t[i] zero, and keeps the carry out in t[i],
+  // to be added back in at the end.
+  // Above it, q and q*m are two multiplies, with scratch of 4n words and
+  // karatsuba_scratch_size(n).
+  void Mod_context::reduce(uint32_t* r, uint32_t* t, uint32_t* scratch) const
+  {
+    const uint32_t* const m = m_modulus.num.d.data();
+    const size_t n = size();
+    uint32_t carry(0u);
+    if (m_inverse_n.empty())
+    {
+      for (size_t i(0); i < n; ++i)
+      {
+        const uint32_t q = t[i] * m_inverse;
+        t[i] = addmul_1(t + i, m, n, q);
+      }
+      carry = add_n(r, t + n, t, n);
+    }
+    else
+    {
+      uint32_t* const q = scratch;
+      uint32_t* const qm = q + 2u * n;
+      mul_dispatch(q, t, n, m_inverse_n.data(), n, qm + 2u * n);
+      mul_dispatch(qm, q, n, m, n, qm + 2u * n);
+      // the low halves add to 0 or R
+      const uint32_t low_carry = (normalized_size(t, n) != 0u) ? 1u : 0u;
+      carry = add_n(r, t + n, qm + n, n);
+      carry += add_in_place(r, n, &low_carry, 1u);
+    }
+    if ((carry != 0u) or greater_equal_n(r, m, n))
+    {
+      sub_n(r, r, m, n);
+    }
+  }
+
+  void Mod_context::mul(uint32_t* r, const uint32_t* a, const uint32_t* b, Workspace& ws) const
+  {
+    const size_t n = size();
+    uint32_t* const t = ws.reserve(scratch_size());
+    uint32_t* const scratch = t + 2u * n;
+    mul_dispatch(t, a, n, b, n, scratch);
+    reduce(r, t, scratch);
+  }
+
+  void Mod_context::sqr(uint32_t* r, const uint32_t* a, Workspace& ws) const
+  {
+    const size_t n = size();
+    uint32_t* const t = ws.reserve(scratch_size());
+    uint32_t* const scratch = t + 2u * n;
+    sqr_dispatch(t, a, n, scratch);
+    reduce(r, t, scratch);
+  }
+
+  void Mod_context::to_montgomery(uint32_t* r, const uint32_t* x, const size_t xn, Workspace& ws) const
+  {
+    const size_t n = size();
+    if (xn == 0u)
+    {
+      std::fill(r, r + n, 0u);
+      return;
+    }
+    // the remainder of x << (32*n), which is left in u
+    const size_t un = xn + n;
+    uint32_t* const u = ws.reserve(un + (xn + 1u) + div_scratch_size(un, n));
+    uint32_t* const q = u + un;
+    std::fill(u, u + n, 0u);
+    std::copy(x, x + xn, u + n);
+    const size_t rn = divrem_n(q, u, u, un, m_modulus.num.d.data(), n, q + xn + 1u).second;
+    std::copy(u, u + rn, r);
+    std::fill(r + rn, r + n, 0u);
+  }
+
+  void Mod_context::from_montgomery(uint32_t* r, const uint32_t* a, Workspace& ws) const
+  {
+    const size_t n = size();
+    uint32_t* const t = ws.reserve(scratch_size());
+    std::copy(a, a + n, t);
+    std::fill(t + n, t + 2u * n, 0u);
+    reduce(r, t, t + 2u * n);
+  }
+
+  Mont_nat::Mont_nat(const Nat& x, const Mod_context& context)
+    : m_context(&context), m_value(context.size())
+  {
+    Workspace ws;
+    context.to_montgomery(m_value.data(), x.num.d.data(), x.num_word32(), ws);
+  }
+
+  Nat Mont_nat::to_nat() const
+  {
+    Workspace ws;
+    vec32 result(m_value.size());
+    m_context->from_montgomery(result.data(), m_value.data(), ws);
+    result.resize(normalized_size(result.data(), result.size()));
+    return Nat(std::move(result));
+  }
+
+  Mont_nat Mont_nat::operator*(const Mont_nat& b) const
+  {
+    Mont_nat result(*this);
+    result *= b;
+    return result;
+  }
+
+  Mont_nat& Mont_nat::operator*=(const Mont_nat& b)
+  {
+#ifdef _DEBUG
+    assert(m_context == b.m_context);
+#endif
+    Workspace ws(m_context->scratch_size());
+    m_context->mul(m_value.data(), m_value.data(), b.m_value.data(), ws);
+    return *this;
+  }
+
+  Mont_nat Mont_nat::square() const
+  {
+    Mont_nat result(*this);
+    Workspace ws(m_context->scratch_size());
+    m_context->sqr(result.m_value.data(), result.m_value.data(), ws);
+    return result;
+  }
+
+  Barrett_context::Barrett_context(const Nat& m) : m_modulus(m)
+  {
+#ifdef _DEBUG
+    assert(m.is_nonzero());
+#endif
+    const size_t n = m.num_word32();
+    if (n != 0u)
+    {
+      vec32 power(2u * n + 1u, 0u);
+      power.back() = 1u;
+      m_mu = div_vec32(power, m.num.d).first;
+    }
+  }
+
+  size_t Barrett_context::scratch_size() const noexcept
+  {
+    // the double length product, then for the reduction: (top of x) * mu,
+    // the low words of q*m, the remainder and the scratch for the multiplies
+    const size_t n = size();
+    return 2u * n + (n + 1u + m_mu.size()) + 2u * n + (n + 1u) + karatsuba_scratch_size(n + 2u);
+  }
+
+  // r[0..n) = x[0..2n) mod m, for x < m*m.
+  // q = floor(floor(x / B**(n-1)) * mu / B**(n+1)), with B = 2**32, is at most
+  // floor(x/m) and at least floor(x/m) - 2.  Then x - q*m < 3m < B**(n+1), so it is found
+  // from the low n+1 words of x and q*m.
+  // Up to KARATSUBA_THRESHOLD only those words of q*m are made, and the words of
+  // the first product that are below word n-1 are left out.  What they would carry
+  // into word n+1 is less than n, so q may be one smaller, and x - q*m < 4m.
+  void Barrett_context::reduce(uint32_t* r, const uint32_t* x, uint32_t* scratch) const
+  {
+    const uint32_t* const m = m_modulus.num.d.data();
+    const size_t n = size();
+    const size_t mun = m_mu.size();
+    const uint32_t* const x1 = x + (n - 1u);
+    uint32_t* const q2 = scratch;
+    uint32_t* const qm = q2 + (n + 1u + mun);
+    uint32_t* const rem = qm + 2u * n;
+    uint32_t* const mul_scratch = rem + (n + 1u);
+    // q < m, so its words from n on are zero
+    const uint32_t* const q = q2 + (n + 1u);
+
+    if (n < KARATSUBA_THRESHOLD)
+    {
+      std::fill(q2, q2 + (n + 1u + mun), 0u);
+      for (size_t i(0); i <= n; ++i)
+      {
+        const size_t j = (i < n - 1u) ? n - 1u - i : 0u;
+        q2[i + mun] = addmul_1(q2 + i + j, m_mu.data() + j, mun - j, x1[i]);
+      }
+      qm[n] = mul_1(qm, m, n, q[0]);
+      for (size_t i(1); i < n; ++i)
+      {
+        addmul_1(qm + i, m, n + 1u - i, q[i]);
+      }
+    }
+    else
+    {
+      if (n + 1u <= mun)
+      {
+        mul_dispatch(q2, x1, n + 1u, m_mu.data(), mun, mul_scratch);
+      }
+      else
+      {
+        mul_dispatch(q2, m_mu.data(), mun, x1, n + 1u, mul_scratch);
+      }
+      mul_dispatch(qm, q, n, m, n, mul_scratch);
+    }
+    sub_n(rem, x, qm, n + 1u);
+    while ((rem[n] != 0u) or greater_equal_n(rem, m, n))
+    {
+      rem[n] -= sub_n(rem, rem, m, n);
+    }
+    std::copy(rem, rem + n, r);
+  }
+
+  void Barrett_context::mul(uint32_t* r, const uint32_t* a, const uint32_t* b, Workspace& ws) const
+  {
+    const size_t n = size();
+    uint32_t* const t = ws.reserve(scratch_size());
+    uint32_t* const scratch = t + 2u * n;
+    mul_dispatch(t, a, n, b, n, scratch);
+    reduce(r, t, scratch);
+  }
+
+  void Barrett_context::sqr(uint32_t* r, const uint32_t* a, Workspace& ws) const
+  {
+    const size_t n = size();
+    uint32_t* const t = ws.reserve(scratch_size());
+    uint32_t* const scratch = t + 2u * n;
+    sqr_dispatch(t, a, n, scratch);
+    reduce(r, t, scratch);
+  }
+
+  Nat mulmod(const Nat& a, const Nat& b, const Nat& m)
+  {
+    return mod(mul(a, b), m);
+  }
+
+  // a mod m, in size words
+  static vec32 residue_of_size(const Nat& a, const Nat& m, const size_t size)
+  {
+    vec32 result = (a < m) ? a.num.d : mod(a, m).num.d;
+    result.resize(size, 0u);
+    return result;
+  }
+
+  Nat mulmod(const Nat& a, const Nat& b, const Barrett_context& m)
+  {
+    const size_t n = m.size();
+    if (n == 0u)
+    {
+      return Nat();
+    }
+    const vec32 ar = residue_of_size(a, m.modulus(), n);
+    const vec32 br = residue_of_size(b, m.modulus(), n);
+    vec32 result(n);
+    Workspace ws(m.scratch_size());
+    m.mul(result.data(), ar.data(), br.data(), ws);
+    result.resize(normalized_size(result.data(), n));
+    return Nat(std::move(result));
+  }
+
+  // The window for sliding window exponentiation, from the number of bits in the
+  // exponent.  A window of k bits needs a table of 2**(k-1) odd powers, so it only
+  // pays for long exponents (the limits are GMP's).
+  static unsigned powmod_window_size(const size_t bits) noexcept
+  {
+    static const size_t limits[] = { 7u, 25u, 81u, 241u, 673u, 1793u, 4609u };
+    unsigned k(1u);
+    for (const size_t limit : limits)
+    {
+      if (bits <= limit)
+      {
+        return k;
+      }
+      ++k;
+    }
+    return k;
+  }
+
+  static unsigned bit_of(const uint32_t* e, const size_t i) noexcept
+  {
+    return (e[i / 32u] >> (i % 32u)) & 1u;
+  }
+
+  // r = x**e for a residue x of a Mod_context or Barrett_context, where e[0..en) > 0,
+  // by the left to right sliding window method (HAC 14.85).  Each run of at most k bits
+  // of e that starts and ends with a 1 is one multiply by an odd power of x from a table,
+  // so there are about bits/(k+1) multiplies besides the squares, instead of bits/2.
+  // All of the residues are in one table and r, so there is no allocation per step.
+  template <typename Context>
+  static void powmod_sliding_window(uint32_t* r, const uint32_t* x, const uint32_t* e, const size_t en,
+                                    const Context& context)
+  {
+    const size_t n = context.size();
+    const size_t bits = 32u * en - leading_zeros(e[en - 1u]);
+    const unsigned k = powmod_window_size(bits);
+    Workspace ws(context.scratch_size());
+
+    // table[i] = x**(2i+1)
+    const size_t table_size = size_t(1) << (k - 1u);
+    vec32 table(table_size * n);
+    std::copy(x, x + n, table.begin());
+    if (table_size > 1u)
+    {
+      vec32 x2(n);
+      context.sqr(x2.data(), x, ws);
+      for (size_t i(1); i < table_size; ++i)
+      {
+        context.mul(table.data() + i * n, table.data() + (i - 1u) * n, x2.data(), ws);
+      }
+    }
+
+    // The top bit is 1, so r is set by the first window.
+    bool first(true);
+    size_t i(bits);
+    while (i != 0u)
+    {
+      --i;
+      if (bit_of(e, i) == 0u)
+      {
+        context.sqr(r, r, ws);
+        continue;
+      }
+      // the window is bits [j, i] of e
+      size_t j = (i + 1u >= k) ? i + 1u - k : 0u;
+      while (bit_of(e, j) == 0u)
+      {
+        ++j;
+      }
+      size_t value(0u);
+      for (size_t b(i + 1u); b != j; )
+      {
+        --b;
+        value = (value << 1u) | bit_of(e, b);
+      }
+      const uint32_t* const power = table.data() + (value >> 1u) * n;
+      if (first)
+      {
+        std::copy(power, power + n, r);
+        first = false;
+      }
+      else
+      {
+        for (size_t s(j); s <= i; ++s)
+        {
+          context.sqr(r, r, ws);
+        }
+        context.mul(r, r, power, ws);
+      }
+      i = j;
+    }
+  }
+
+  Nat powmod(const Nat& base, const Nat& exp, const Nat& m)
+  {
+    if (m.is_zero())
+    {
+      return Nat();
+    }
+    if ((m.ls_word() & 1u) != 0u)
+    {
+      return powmod(base, exp, Mod_context(m));
+    }
+    return powmod(base, exp, Barrett_context(m));
+  }
+
+  Nat powmod(const Nat& base, const Nat& exp, const Mod_context& m)
+  {
+    const size_t n = m.size();
+    if ((n == 0u) or exp.is_zero())
+    {
+      return mod(Nat(1u), m.modulus());
+    }
+    Workspace ws;
+    vec32 result(n);
+    m.to_montgomery(result.data(), base.num.d.data(), base.num_word32(), ws);
+    const vec32 x(result);
+    powmod_sliding_window(result.data(), x.data(), exp.num.d.data(), exp.num_word32(), m);
+    m.from_montgomery(result.data(), result.data(), ws);
+    result.resize(normalized_size(result.data(), n));
+    return Nat(std::move(result));
+  }
+
+  Nat powmod(const Nat& base, const Nat& exp, const Barrett_context& m)
+  {
+    const size_t n = m.size();
+    if ((n == 0u) or exp.is_zero())
+    {
+      return mod(Nat(1u), m.modulus());
+    }
+    const vec32 x = residue_of_size(base, m.modulus(), n);
+    vec32 result(n);
+    powmod_sliding_window(result.data(), x.data(), exp.num.d.data(), exp.num_word32(), m);
+    result.resize(normalized_size(result.data(), n));
+    return Nat(std::move(result));
+  }
+
+  Nat pow(const Nat& base, const uint64_t exp)
+  {
+    if (exp == 0u)
+    {
+      return Nat(1u);
+    }
+    if (base.is_zero())
+    {
+      return Nat();
+    }
+
+    // base = odd * 2**shift, and the power of two is a shift at the end
+    const uint32_t* const b = base.num.d.data();
+    size_t zero_words(0);
+    while (b[zero_words] == 0u)
+    {
+      ++zero_words;
+    }
+    const unsigned zero_bits = trailing_zeros(b[zero_words]);
+    vec32 odd(base.num_word32() - zero_words);
+    rshift_n(odd.data(), b + zero_words, odd.size(), zero_bits);
+    odd.resize(normalized_size(odd.data(), odd.size()));
+    const size_t oddn = odd.size();
+    const uint64_t odd_bits = 32u * uint64_t(oddn) - leading_zeros(odd.back());
+    const uint64_t shift = 32u * uint64_t(zero_words) + zero_bits;
+
+    // odd**exp has at most odd_bits*exp bits (just 1 if odd is 1)
+    const uint64_t max_bits = 32u * uint64_t(std::numeric_limits<size_t>::max() / 64u);
+    if (odd_bits + shift > max_bits / exp)
+    {
+      throw std::length_error("pow: the result is too large");
+    }
+    const size_t words = (odd_bits == 1u) ? 1u : size_t((odd_bits * exp + 31u) / 32u);
+
+    // Left to right binary exponentiation, from one buffer to the other and back.
+    // A product may write one more word than it needs.
+    vec32 x(words + 1u);
+    vec32 y(words + 1u);
+    uint32_t* r = x.data();
+    uint32_t* t = y.data();
+    std::copy(odd.begin(), odd.end(), r);
+    size_t rn(oddn);
+    Workspace ws(std::max(sqr_scratch_size(words), mul_scratch_size(words, oddn)));
+    unsigned i(63u);
+    while (((exp >> i) & 1u) == 0u)
+    {
+      --i;
+    }
+    while (i != 0u)
+    {
+      --i;
+      rn = sqr_vec32(t, r, rn, ws);
+      std::swap(r, t);
+      if (((exp >> i) & 1u) != 0u)
+      {
+        rn = mul_vec32(t, r, rn, odd.data(), oddn, ws);
+        std::swap(r, t);
+      }
+    }
+
+    const uint64_t result_shift = shift * exp;
+    const size_t shift_words = size_t(result_shift / 32u);
+    vec32 result(shift_words + rn + 1u, 0u);
+    result[shift_words + rn] = lshift_n(result.data() + shift_words, r, rn, unsigned(result_shift % 32u));
+    result.resize(normalized_size(result.data(), result.size()));
+    return Nat(std::move(result));
+  }
+
+  // gcd
+
+  static unsigned trailing_zeros_dword(const uint64_t w) noexcept
+  {
+    return (uint32_t(w) != 0u) ? trailing_zeros(uint32_t(w)) : 32u + trailing_zeros(uint32_t(w >> 32u));
+  }
+
+  // Stein's binary gcd
+  static uint64_t gcd_dword(uint64_t u, uint64_t v) noexcept
+  {
+    if ((u == 0u) or (v == 0u))
+    {
+      return u | v;
+    }
+    const unsigned shift = trailing_zeros_dword(u | v);
+    u >>= trailing_zeros_dword(u);
+    do
+    {
+      v >>= trailing_zeros_dword(v);
+      if (u > v)
+      {
+        std::swap(u, v);
+      }
+      v -= u;
+    } while (v != 0u);
+    return u << shift;
+  }
+
+  static uint64_t dword_of(const uint32_t* a, const size_t n) noexcept
+  {
+    return (n == 0u) ? 0u : (n == 1u) ? a[0] : (uint64_t(a[1]) << 32u) | a[0];
+  }
+
+  // the number of trailing zero bits of a nonzero a
+  static size_t trailing_zero_bits(const uint32_t* a) noexcept
+  {
+    size_t i(0);
+    while (a[i] == 0u)
+    {
+      ++i;
+    }
+    return 32u * i + trailing_zeros(a[i]);
+  }
+
+  // a[0..n) >>= (the number of its trailing zero bits), for a nonzero a.  Returns the new size.
+  static size_t remove_twos_n(uint32_t* a, size_t n) noexcept
+  {
+    size_t zero_words(0);
+    while (a[zero_words] == 0u)
+    {
+      ++zero_words;
+    }
+    if (zero_words != 0u)
+    {
+      std::copy(a + zero_words, a + n, a);
+      n -= zero_words;
+    }
+    rshift_n(a, a, n, trailing_zeros(a[0]));
+    return normalized_size(a, n);
+  }
+
+  // Stein's binary gcd of odd u and v, in place.  Each step subtracts the smaller from
+  // the larger and removes the twos from the difference, so it is slow unless the sizes
+  // are close.  Returns where the gcd was left (in u or v) and its size.
+  static std::pair<uint32_t*, size_t> gcd_binary_n(uint32_t* u, size_t un, uint32_t* v, size_t vn) noexcept
+  {
+    while ((un > 2u) or (vn > 2u))
+    {
+      if ((un < vn) or ((un == vn) and not greater_equal_n(u, v, un)))
+      {
+        std::swap(u, v);
+        std::swap(un, vn);
+      }
+      sub_in_place(u, un, v, vn);
+      un = normalized_size(u, un);
+      if (un == 0u)
+      {
+        return std::make_pair(v, vn);
+      }
+      un = remove_twos_n(u, un);
+    }
+    const uint64_t g = gcd_dword(dword_of(u, un), dword_of(v, vn));
+    u[0] = uint32_t(g);
+    u[1] = uint32_t(g >> 32u);
+    return std::make_pair(u, normalized_size(u, 2u));
+  }
+
+  // The top bits of a[0..n), from bit number shift up.
+  static uint64_t dword_at_bit(const uint32_t* a, const size_t n, const size_t shift) noexcept
+  {
+    const size_t i = shift / 32u;
+    const unsigned bits = unsigned(shift % 32u);
+    const uint64_t low = dword_of(a + std::min(i, n), n - std::min(i, n));
+    const uint64_t high = (i + 2u < n) ? a[i + 2u] : 0u;
+    return (bits == 0u) ? low : (low >> bits) | (high << (64u - bits));
+  }
+
+  // Lehmer's cofactors (Knuth, The Art of Computer Programming, vol 2, 4.5.2, Algorithm L)
+  // for the leading 62 bits x >= y of u and v.  Euclid's algorithm is run on x and y
+  // while the quotients are certain to be those for u and v, which is when x+A, y+C
+  // and x+B, y+D give the same one.  Then u' = A*u + B*v and v' = C*u + D*v are the
+  // remainders u and v would have reached.  The cofactors are kept less than 2**31.
+  // A and B have opposite signs, as do C and D.  If B is 0 there was no step.
+  // If floor is positive, each new remainder y is also kept at least max(|C|, |D|) + floor,
+  // so the remainder of u and v is at least floor * 2**(the bits below x).
+  struct Lehmer_cofactors
+  {
+    int64_t A, B, C, D;
+  };
+
+  static Lehmer_cofactors lehmer_cofactors(int64_t x, int64_t y, const int64_t floor) noexcept
+  {
+    const int64_t LIMIT = int64_t(1) << 31u;
+    Lehmer_cofactors m = { 1, 0, 0, 1 };
+    while ((y + m.C != 0) and (y + m.D != 0))
+    {
+      const int64_t q = (x + m.A) / (y + m.C);
+      if ((q >= LIMIT) or (q != (x + m.B) / (y + m.D)))
+      {
+        break;
+      }
+      const int64_t C = m.A - q * m.C;
+      const int64_t D = m.B - q * m.D;
+      if ((C <= -LIMIT) or (C >= LIMIT) or (D <= -LIMIT) or (D >= LIMIT))
+      {
+        break;
+      }
+      const int64_t t = x - q * y;
+      if ((floor > 0) and (t - std::max(std::abs(C), std::abs(D)) < floor))
+      {
+        break;
+      }
+      m = { m.C, m.D, C, D };
+      x = y;
+      y = t;
+    }
+    return m;
+  }
+
+  // r[0..n] = a*u + b*v, where n = max(un, vn), for cofactors of opposite signs
+  // and a result known not to be negative.  Returns its size.
+  static size_t lehmer_combination(uint32_t* r, const uint32_t* u, const size_t un, const int64_t a,
+                                   const uint32_t* v, const size_t vn, const int64_t b) noexcept
+  {
+    // r = x*c - y*d, with c and d not negative
+    const bool u_first = (a > 0) or (b < 0);
+    const uint32_t* const x = u_first ? u : v;
+    const size_t xn = u_first ? un : vn;
+    const uint32_t* const y = u_first ? v : u;
+    const size_t yn = u_first ? vn : un;
+    const uint32_t c = uint32_t(u_first ? a : b);
+    const uint32_t d = uint32_t(u_first ? -b : -a);
+    const size_t n = std::max(un, vn);
+    r[xn] = mul_1(r, x, xn, c);
+    std::fill(r + xn + 1u, r + n + 1u, 0u);
+    const uint32_t borrow = submul_1(r, y, yn, d);
+    sub_in_place(r + yn, n + 1u - yn, &borrow, 1u);
+    return normalized_size(r, n + 1u);
+  }
+
+  // Half gcd (Moller, "On Schonhage's algorithm and subquadratic integer gcd computation",
+  // in the form of GMP's mpn_hgcd).
+  //
+  // hgcd reduces a and b of n words by steps of Euclid's algorithm, but only while
+  // both stay longer than s = n/2 + 1 words, and gives the matrix of the steps.
+  // The entries of the matrix are then less than 2**(32*(s-1)), so a matrix found
+  // from the leading words of a and b also reduces all of a and b, correctly:
+  // the low words change the result by less than its leading part.  Recursing on
+  // the leading half twice, with fast multiplies to apply the matrices, makes it
+  // O(M(n) log n) instead of the O(n**2) of Lehmer's algorithm.
+
+  // (a;b) = M (alpha;beta) for the numbers alpha, beta that a, b are reduced to.
+  // The entries are not negative, and det is the determinant, +1 or -1.
+  struct Hgcd_matrix
+  {
+    vec32 m[2][2];
+    int det;
+  };
+
+  static void hgcd_identity(Hgcd_matrix& M)
+  {
+    M.m[0][0].assign(1u, 1u);
+    M.m[0][1].clear();
+    M.m[1][0].clear();
+    M.m[1][1].assign(1u, 1u);
+    M.det = 1;
+  }
+
+  // for swapping alpha and beta
+  static void hgcd_swap_columns(Hgcd_matrix& M) noexcept
+  {
+    M.m[0][0].swap(M.m[0][1]);
+    M.m[1][0].swap(M.m[1][1]);
+    M.det = -M.det;
+  }
+
+  // M = M * K
+  static void hgcd_matrix_mul(Hgcd_matrix& M, const Hgcd_matrix& K)
+  {
+    for (unsigned i(0); i < 2u; ++i)
+    {
+      vec32 r0 = add_vec32(mul_vec32(M.m[i][0], K.m[0][0]), mul_vec32(M.m[i][1], K.m[1][0]));
+      vec32 r1 = add_vec32(mul_vec32(M.m[i][0], K.m[0][1]), mul_vec32(M.m[i][1], K.m[1][1]));
+      M.m[i][0].swap(r0);
+      M.m[i][1].swap(r1);
+    }
+    M.det *= K.det;
+  }
+
+  // (x, y) = (x*a + y*c, x*b + y*d), for a, b, c, d < 2**31, so each sum of two products fits
+  // in 64 bits.
+  static void mul_pair_by_cofactors(vec32& x, vec32& y, const uint32_t a, const uint32_t b,
+                                    const uint32_t c, const uint32_t d)
+  {
+    const size_t n = std::max(x.size(), y.size()) + 1u;
+    x.resize(n, 0u);
+    y.resize(n, 0u);
+    uint64_t x_carry(0u);
+    uint64_t y_carry(0u);
+    for (size_t i(0); i < n; ++i)
+    {
+      const uint64_t xi = x[i];
+      const uint64_t yi = y[i];
+      const uint64_t new_x = xi * a + yi * c + x_carry;
+      const uint64_t new_y = xi * b + yi * d + y_carry;
+      x[i] = uint32_t(new_x);
+      y[i] = uint32_t(new_y);
+      x_carry = new_x >> 32u;
+      y_carry = new_y >> 32u;
+    }
+    remove_MSW_zeros(x);
+    remove_MSW_zeros(y);
+  }
+
+  // (a, b) = M**-1 (a, b).  Both results are known not to be negative.
+  static void hgcd_adjust(vec32& a, vec32& b, const Hgcd_matrix& M)
+  {
+    vec32 alpha = symdiff_vec32(mul_vec32(M.m[1][1], a), mul_vec32(M.m[0][1], b)).first;
+    vec32 beta = symdiff_vec32(mul_vec32(M.m[0][0], b), mul_vec32(M.m[1][0], a)).first;
+    a.swap(alpha);
+    b.swap(beta);
+  }
+
+  // One step of hgcd, which leaves a and b longer than s words: the Lehmer cofactors
+  // from the leading 62 bits, or if there are none, a division.  M = M * (the step).
+  // t and w are for the new a and b, and are left with the memory of the old ones.
+  // Returns false if no step could be done.
+  static bool hgcd_step(vec32& a, vec32& b, const size_t s, Hgcd_matrix& M, vec32& t, vec32& w)
+  {
+    if (less_than(a, b))
+    {
+      a.swap(b);
+      hgcd_swap_columns(M);
+    }
+    if (b.size() <= s)
+    {
+      return false;
+    }
+
+    // The remainders must be at least 2**(32*s), which is 2**(32*s - shift) in units
+    // of the leading bits.
+    const size_t a_bits = 32u * a.size() - leading_zeros(a.back());
+    const size_t shift = (a_bits > 62u) ? a_bits - 62u : 0u;
+    const size_t floor_bits = (32u * s > shift) ? 32u * s - shift : 0u;
+    Lehmer_cofactors m = { 1, 0, 0, 1 };
+    const int64_t y = int64_t(dword_at_bit(b.data(), b.size(), shift));
+    if ((y != 0) and (floor_bits < 60u))
+    {
+      m = lehmer_cofactors(int64_t(dword_at_bit(a.data(), a.size(), shift)), y, int64_t(1) << floor_bits);
+    }
+    if (m.B != 0)
+    {
+      const size_t n = a.size() + 1u;
+      t.resize(n);
+      w.resize(n);
+      t.resize(lehmer_combination(t.data(), a.data(), a.size(), m.A, b.data(), b.size(), m.B));
+      w.resize(lehmer_combination(w.data(), a.data(), a.size(), m.C, b.data(), b.size(), m.D));
+      a.swap(t);
+      b.swap(w);
+      // (a;b) was (|D| |B|; |C| |A|) times the new (a;b), with determinant the sign of D
+      const uint32_t A = uint32_t(std::abs(m.A));
+      const uint32_t B = uint32_t(std::abs(m.B));
+      const uint32_t C = uint32_t(std::abs(m.C));
+      const uint32_t D = uint32_t(std::abs(m.D));
+      mul_pair_by_cofactors(M.m[0][0], M.m[0][1], D, B, C, A);
+      mul_pair_by_cofactors(M.m[1][0], M.m[1][1], D, B, C, A);
+      if (m.D < 0)
+      {
+        M.det = -M.det;
+      }
+      return true;
+    }
+
+    // a = a - q*b, with q one smaller than the quotient if that leaves too small a remainder
+    std::pair<vec32, vec32> qr = div_vec32(a, b);
+    if (qr.second.size() <= s)
+    {
+      if ((qr.first.size() == 1u) and (qr.first[0] == 1u))
+      {
+        return false;
+      }
+      decrement_by_word(qr.first, 1u);
+      qr.second = add_vec32(qr.second, b);
+    }
+    a.swap(qr.second);
+    // (a;b) was (1 q; 0 1) times the new (a;b)
+    M.m[0][1] = add_vec32(M.m[0][1], mul_vec32(M.m[0][0], qr.first));
+    M.m[1][1] = add_vec32(M.m[1][1], mul_vec32(M.m[1][0], qr.first));
+    return true;
+  }
+
+  static bool hgcd(vec32& a, vec32& b, Hgcd_matrix& M);
+
+  // hgcd of the words of a and b from p up, then a and b reduced by its matrix
+  static bool hgcd_top(vec32& a, vec32& b, const size_t p, Hgcd_matrix& M)
+  {
+    if ((a.size() <= p) or (b.size() <= p))
+    {
+      return false;
+    }
+    vec32 a_top(a.begin() + p, a.end());
+    vec32 b_top(b.begin() + p, b.end());
+    if (not hgcd(a_top, b_top, M))
+    {
+      // hgcd may have swapped the columns of M with the tops, but a and b are unchanged
+      hgcd_identity(M);
+      return false;
+    }
+    hgcd_adjust(a, b, M);
+    return true;
+  }
+
+  // Reduces a and b of n words (at most) until one more step would make one of them
+  // s = n/2 + 1 words or less, with M for the steps.  Returns false if there was no step.
+  static bool hgcd(vec32& a, vec32& b, Hgcd_matrix& M)
+  {
+    hgcd_identity(M);
+    const size_t n = std::max(a.size(), b.size());
+    const size_t s = n / 2u + 1u;
+    if (std::min(a.size(), b.size()) <= s)
+    {
+      return false;
+    }
+    vec32 t;
+    vec32 w;
+    bool progress(false);
+    if (n >= HGCD_THRESHOLD)
+    {
+      // The leading n - n/2 words reduce a and b to about 3n/4 words.
+      progress = hgcd_top(a, b, n / 2u, M);
+      const size_t n2 = 3u * n / 4u + 1u;
+      while (std::max(a.size(), b.size()) > n2)
+      {
+        if (not hgcd_step(a, b, s, M, t, w))
+        {
+          return progress;
+        }
+        progress = true;
+      }
+      // Then the leading words from p, chosen so that the second hgcd also stops
+      // above s words, reduce them to about n/2 words.
+      const size_t n3 = std::max(a.size(), b.size());
+      if (n3 > s + 2u)
+      {
+        Hgcd_matrix K;
+        if (hgcd_top(a, b, 2u * s - n3 + 1u, K))
+        {
+          hgcd_matrix_mul(M, K);
+          progress = true;
+        }
+      }
+    }
+    while (hgcd_step(a, b, s, M, t, w))
+    {
+      progress = true;
+    }
+    return progress;
+  }
+
+  // Reduces u and v with hgcd while both are at least GCD_HGCD_THRESHOLD words, leaving
+  // numbers with the same gcd.  As in GMP's gcd, hgcd is only given the leading 2/3 of
+  // the words, because the matrix is not needed.  A division is done if it makes no step.
+  static void gcd_reduce_hgcd(vec32& u, vec32& v)
+  {
+    Hgcd_matrix M;
+    while (true)
+    {
+      if (less_than(u, v))
+      {
+        u.swap(v);
+      }
+      if (v.size() < GCD_HGCD_THRESHOLD)
+      {
+        return;
+      }
+      if (not hgcd_top(u, v, u.size() / 3u, M))
+      {
+        vec32 r = div_vec32(u, v).second;
+        u.swap(r);
+      }
+    }
+  }
+
+  // The buffers u, v, t, w of n words each, in ws.remainders.
+  static uint32_t* gcd_buffers(Gcd_workspace& ws, const size_t n)
+  {
+    if (ws.remainders.size() < 4u * n)
+    {
+      ws.remainders.resize(4u * n);
+    }
+    return ws.remainders.data();
+  }
+
+  Nat gcd(const Nat& a, const Nat& b)
+  {
+    Gcd_workspace ws;
+    return gcd(a, b, ws);
+  }
+
+  Nat gcd(const Nat& a, const Nat& b, Gcd_workspace& ws)
+  {
+    if (a.is_zero() or b.is_zero())
+    {
+      return a.is_zero() ? b : a;
+    }
+
+    // Working copies u, v, and t, w for the Lehmer steps, each with an extra word,
+    // and ws.division for the quotients and scratch of the divisions.
+    // The gcd of the odd parts of a and b is shifted by the common power of two at the end.
+    const size_t n = std::max(a.num_word32(), b.num_word32()) + 1u;
+    uint32_t* u = gcd_buffers(ws, n);
+    uint32_t* v = u + n;
+    uint32_t* t = v + n;
+    uint32_t* w = t + n;
+    std::copy(a.num.d.begin(), a.num.d.end(), u);
+    std::copy(b.num.d.begin(), b.num.d.end(), v);
+    size_t un = a.num_word32();
+    size_t vn = b.num_word32();
+    const size_t twos = std::min(trailing_zero_bits(u), trailing_zero_bits(v));
+    un = remove_twos_n(u, un);
+    vn = remove_twos_n(v, vn);
+    if (std::min(un, vn) >= GCD_HGCD_THRESHOLD)
+    {
+      vec32 x(u, u + un);
+      vec32 y(v, v + vn);
+      gcd_reduce_hgcd(x, y);
+      un = x.size();
+      vn = y.size();
+      std::copy(x.begin(), x.end(), u);
+      std::copy(y.begin(), y.end(), v);
+    }
+
+    while (true)
+    {
+      if ((un < vn) or ((un == vn) and not greater_equal_n(u, v, un)))
+      {
+        std::swap(u, v);
+        std::swap(un, vn);
+      }
+      if (vn == 0u)
+      {
+        break;
+      }
+      // u >= v, so the leading 62 bits of u start at bit shift
+      const size_t u_bits = 32u * un - leading_zeros(u[un - 1u]);
+      const size_t shift = (u_bits > 62u) ? u_bits - 62u : 0u;
+      const int64_t y = int64_t(dword_at_bit(v, vn, shift));
+      if ((vn < GCD_LEHMER_THRESHOLD) and (un <= vn + 1u))
+      {
+        break;
+      }
+      const Lehmer_cofactors m = (y == 0) ? Lehmer_cofactors{ 1, 0, 0, 1 }
+                                          : lehmer_cofactors(int64_t(dword_at_bit(u, un, shift)), y, 0);
+      if (m.B == 0)
+      {
+        // v is much smaller than u, or the first quotient is too large: u = u % v
+        uint32_t* const q = ws.division.reserve(un - vn + 1u + div_scratch_size(un, vn));
+        un = divrem_n(q, u, u, un, v, vn, q + (un - vn + 1u)).second;
+      }
+      else
+      {
+        const size_t tn = lehmer_combination(t, u, un, m.A, v, vn, m.B);
+        vn = lehmer_combination(w, u, un, m.C, v, vn, m.D);
+        un = tn;
+        std::swap(u, t);
+        std::swap(v, w);
+      }
+    }
+
+    std::pair<uint32_t*, size_t> g(u, un);
+    if (vn != 0u)
+    {
+      un = remove_twos_n(u, un);
+      vn = remove_twos_n(v, vn);
+      g = gcd_binary_n(u, un, v, vn);
+    }
+
+    vec32 result(twos / 32u + g.second + 1u, 0u);
+    result[twos / 32u + g.second] = lshift_n(result.data() + twos / 32u, g.first, g.second, unsigned(twos % 32u));
+    result.resize(normalized_size(result.data(), result.size()));
+    return Nat(std::move(result));
+  }
+
+  // gcdext
+
+  // x += q[0..qn) * y
+  static void add_product(vec32& x, const uint32_t* q, const size_t qn, const vec32& y)
+  {
+    if (y.empty())
+    {
+      return;
+    }
+    const size_t n = std::max(x.size(), qn + y.size()) + 1u;
+    x.resize(n, 0u);
+    for (size_t i(0); i < qn; ++i)
+    {
+      const uint32_t carry = addmul_1(x.data() + i, y.data(), y.size(), q[i]);
+      add_in_place(x.data() + i + y.size(), n - i - y.size(), &carry, 1u);
+    }
+    remove_MSW_zeros(x);
+  }
 
-          increment_at_index_by_word(ret_quotient, index_of_work, quot_w);  // increase the (quotient*d) value
-#ifdef _DEBUG
-          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
-#endif
-        }
-        else
-        {
-          // can use (d_MSW+1) for trial divide
-          // proof that the quotient obtained fits in 32 bits:
-          // since here,  d_MSDW > rem_MSWs
-          // so           d_MSW*2**32 >= rem_MSWs
-          //              (d_MSW+1)*2**32 > rem_MSWs
-          // or           2**32 > rem_MSWs/(d_MSW+1)
-          // QED
-          const uint64_t high_quotd = rem_MSWs / (uint64_t(d_MSW) + 1u);
-#ifdef _DEBUG
-          assert(high_quotd < 0x1'0000'0000ull);
-#endif
-          const uint32_t high_quotw = uint32_t(high_quotd);
-#ifdef _DEBUG
-          assert(high_quotw != 0);
-#endif
-          const size_t index_of_work = rsize - dsize - 1u;
+  // The cofactors of a are kept for u and v, as u = su*a and v = sv*a modulo b.
+  // Every step, Euclid's or a matrix of them, gives su and sv opposite signs, so
+  // only their absolute values are kept, and the sign of su: the new ones are then
+  // sums of products with the absolute values of the cofactors of the step.
 
-          // ret_remainder -= word_shift( d*high_quotw, index_of_work)
-          sub_product_at_index(ret_remainder, index_of_work, d, high_quotw);
-          //const vec32 product = mul_vec32_by_word(d, high_quotw);
-          //decrement_at_index(ret_remainder, index_of_work, product);  // decrement remainder by product at index
-          increment_at_index_by_word(ret_quotient, index_of_work, high_quotw);  // increase the (quotient*d) value
-#ifdef _DEBUG
-          assert(loop_invariant(n, d, ret_quotient, ret_remainder));
-#endif
+  // gcd_reduce_hgcd, with the cofactors
+  static void gcdext_reduce_hgcd(vec32& u, vec32& v, vec32& su, vec32& sv, bool& u_negative)
+  {
+    Hgcd_matrix M;
+    while (true)
+    {
+      if (less_than(u, v))
+      {
+        u.swap(v);
+        su.swap(sv);
+        u_negative = not u_negative;
+      }
+      if (v.size() < GCD_HGCD_THRESHOLD)
+      {
+        return;
+      }
+      if (hgcd_top(u, v, u.size() / 3u, M))
+      {
+        // the new (u;v) is det (m11 -m01; -m10 m00) times the old, and so are the cofactors
+        vec32 s = add_vec32(mul_vec32(M.m[1][1], su), mul_vec32(M.m[0][1], sv));
+        vec32 t = add_vec32(mul_vec32(M.m[1][0], su), mul_vec32(M.m[0][0], sv));
+        su.swap(s);
+        sv.swap(t);
+        if (M.det < 0)
+        {
+          u_negative = not u_negative;
         }
-        rsize = ret_remainder.size();
+      }
+      else
+      {
+        std::pair<vec32, vec32> qr = div_vec32(u, v);
+        u.swap(qr.second);
+        add_product(su, qr.first.data(), qr.first.size(), sv);
+      }
+    }
+  }
 
-      } // while
+  // The gcd of nonzero a and b, in ws.remainders, and the sign of its cofactor s,
+  // with |s| in ws.cofactors[0].
+  struct Gcdext_state
+  {
+    const uint32_t* g;
+    size_t gn;
+    bool s_negative;
+  };
 
-        // remove any 0 MSWs left in the quotient
-      while ((ret_quotient.size() != 0) && (ret_quotient.back() == 0))
+  // The Lehmer loop of gcd, with the cofactors, and run to the end instead of
+  // finishing with the binary gcd, whose steps have no simple cofactors.
+  static Gcdext_state gcdext_n(const Nat& a, const Nat& b, Gcd_workspace& ws)
+  {
+    const size_t n = std::max(a.num_word32(), b.num_word32()) + 1u;
+    uint32_t* u = gcd_buffers(ws, n);
+    uint32_t* v = u + n;
+    uint32_t* t = v + n;
+    uint32_t* w = t + n;
+    std::copy(a.num.d.begin(), a.num.d.end(), u);
+    std::copy(b.num.d.begin(), b.num.d.end(), v);
+    size_t un = a.num_word32();
+    size_t vn = b.num_word32();
+    vec32& su = ws.cofactors[0];
+    vec32& sv = ws.cofactors[1];
+    su.assign(1u, 1u);
+    sv.clear();
+    bool u_negative(false);
+    if (std::min(un, vn) >= GCD_HGCD_THRESHOLD)
+    {
+      vec32 x(u, u + un);
+      vec32 y(v, v + vn);
+      gcdext_reduce_hgcd(x, y, su, sv, u_negative);
+      un = x.size();
+      vn = y.size();
+      std::copy(x.begin(), x.end(), u);
+      std::copy(y.begin(), y.end(), v);
+    }
+
+    while (true)
+    {
+      if ((un < vn) or ((un == vn) and not greater_equal_n(u, v, un)))
       {
-        ret_quotient.pop_back();
+        std::swap(u, v);
+        std::swap(un, vn);
+        su.swap(sv);
+        u_negative = not u_negative;
+      }
+      if (vn == 0u)
+      {
+        break;
+      }
+      const size_t u_bits = 32u * un - leading_zeros(u[un - 1u]);
+      const size_t shift = (u_bits > 62u) ? u_bits - 62u : 0u;
+      const int64_t y = int64_t(dword_at_bit(v, vn, shift));
+      const Lehmer_cofactors m = (y == 0) ? Lehmer_cofactors{ 1, 0, 0, 1 }
+                                          : lehmer_cofactors(int64_t(dword_at_bit(u, un, shift)), y, 0);
+      if (m.B == 0)
+      {
+        // u = u % v, su = su + (u / v)*sv
+        uint32_t* const q = ws.division.reserve(un - vn + 1u + div_scratch_size(un, vn));
+        const std::pair<size_t, size_t> qr = divrem_n(q, u, u, un, v, vn, q + (un - vn + 1u));
+        un = qr.second;
+        add_product(su, q, qr.first, sv);
+      }
+      else
+      {
+        const size_t tn = lehmer_combination(t, u, un, m.A, v, vn, m.B);
+        vn = lehmer_combination(w, u, un, m.C, v, vn, m.D);
+        un = tn;
+        std::swap(u, t);
+        std::swap(v, w);
+        // su = |A| su + |B| sv and sv = |C| su + |D| sv, and A > 0 keeps the sign of su
+        mul_pair_by_cofactors(su, sv, uint32_t(std::abs(m.A)), uint32_t(std::abs(m.C)),
+                              uint32_t(std::abs(m.B)), uint32_t(std::abs(m.D)));
+        if (m.A <= 0)
+        {
+          u_negative = not u_negative;
+        }
       }
+    }
+    return Gcdext_state{ u, un, u_negative and not su.empty() };
+  }
+
+  Gcdext_result gcdext(const Nat& a, const Nat& b)
+  {
+    Gcd_workspace ws;
+    return gcdext(a, b, ws);
+  }
+
+  Gcdext_result gcdext(const Nat& a, const Nat& b, Gcd_workspace& ws)
+  {
+    if (b.is_zero())
+    {
+      return Gcdext_result{ a, Int(a.is_zero() ? vec32() : vec32(1u, 1u), false), Int(vec32(), false) };
+    }
+    if (a.is_zero())
+    {
+      return Gcdext_result{ b, Int(vec32(), false), Int(vec32(1u, 1u), false) };
+    }
+    const Gcdext_state state = gcdext_n(a, b, ws);
+    const vec32& s = ws.cofactors[0];
+    const vec32 g(state.g, state.g + state.gn);
+
+    // t = (g - s*a)/b, which is positive if s is negative
+    const vec32 sa = mul_vec32(s, a.num.d);
+    std::pair<vec32, bool> bt = state.s_negative ? std::make_pair(add_vec32(sa, g), false)
+                                                 : symdiff_vec32(sa, g);
+    const Nat t = divexact(Nat(std::move(bt.first)), b);
+    return Gcdext_result{ Nat(g), Int(vec32(s), state.s_negative),
+                          Int(vec32(t.num.d), bt.second and t.is_nonzero()) };
+  }
+
+  std::pair<bool, Nat> invmod(const Nat& a, const Nat& m)
+  {
+    Gcd_workspace ws;
+    return invmod(a, m, ws);
+  }
+
+  std::pair<bool, Nat> invmod(const Nat& a, const Nat& m, Gcd_workspace& ws)
+  {
+    if (m.is_zero() or ((m.num_word32() == 1u) and (m.ls_word() == 1u)))
+    {
+      return std::make_pair(m.is_nonzero(), Nat());  // everything is 0 = 1 modulo 1
+    }
+    if (a.is_zero())
+    {
+      return std::make_pair(false, Nat());
+    }
+    const Gcdext_state state = gcdext_n(a, m, ws);
+    if ((state.gn != 1u) or (state.g[0] != 1u))
+    {
+      return std::make_pair(false, Nat());
+    }
+    const vec32& s = ws.cofactors[0];
 #ifdef _DEBUG
-      assert(loop_invariant(n, d, ret_quotient, ret_remainder));
+    assert(less_than(s, m.num.d));
 #endif
-      //std::cout << " loopcount=" << loopcount << " sizeof n=" << nsize << " sizeof d=" << dsize << std::endl;
+    return std::make_pair(true, state.s_negative ? Nat(symdiff_vec32(m.num.d, s).first) : Nat(s));
+  }
 
+  // Int
 
-    }  // endif nonzero divisor
-    return result;
+  // a + b for magnitudes a and b with the given signs, as signed_add
+  static Int add_signed(const vec32& a, const bool a_negative, const vec32& b, const bool b_negative)
+  {
+    if (a_negative == b_negative)
+    {
+      return Int(add_vec32(a, b), a_negative and (test_nonzero(a) or test_nonzero(b)));
+    }
+    // a + b has the sign of the one with the larger magnitude
+    std::pair<vec32, bool> diff = symdiff_vec32(a, b);  // second is true if a >= b
+    const bool negative = (diff.second ? a_negative : b_negative) and test_nonzero(diff.first);
+    return Int(std::move(diff.first), negative);
   }
 
+  Int add(const Int& a, const Int& b)
+  {
+    return add_signed(a.num.d, a.num.negative, b.num.d, b.num.negative);
+  }
 
+  Int sub(const Int& a, const Int& b)
+  {
+    return add_signed(a.num.d, a.num.negative, b.num.d, not b.num.negative);
+  }
 
-  // precondition: b.size() >= a.size()
-  // postcondition:  b is modified to (a*b)
-  void mul_ordered_in_place(const vec32& a, vec32& b)
+  Int mul(const Int& a, const Int& b)
   {
-    if (1u == a.size())
+    vec32 product = mul_vec32(a.num.d, b.num.d);
+    const bool negative = (a.num.negative != b.num.negative) and test_nonzero(product);
+    return Int(std::move(product), negative);
+  }
+
+  // a += b for the magnitude a with the sign a_negative, in the words of a
+  static void add_signed_in_place(vec32& a, bool& a_negative, const vec32& b, const bool b_negative)
+  {
+    if (a_negative == b_negative)
     {
-      scale_by_word(b, a[0]);
+      increment_by_vec32(a, b);
+    }
+    else if (not less_than(a, b))
+    {
+      decrement_by_vec32(a, b);
     }
     else
     {
-      vec32 result = mul_ordered(a, b);
-      b = result;  // replace contents!
+      subtract_from_vec32(a, b);
+      a_negative = b_negative;
     }
+    a_negative = a_negative and test_nonzero(a);
   }
 
+  Int operator+(const Int& a, const Int& b)
+  {
+    return add(a, b);
+  }
 
-  Nat mul(const Nat& a, const Nat& b)
+  Int operator+(Int&& a, const Int& b)
   {
-    // calculate convolution sum a[i]*b[j] for i+j = pos
-    // the value goes in the "pos" position.
-    // pos runs from 0 to a.size()+b.size()-2.
-    // example ab*de = be at pos=0, ad+be at pos=1, ad at pos=2
+    add_signed_in_place(a.num.d, a.num.negative, b.num.d, b.num.negative);
+    return std::move(a);
+  }
 
-    vec32 result;
+  Int operator+(const Int& a, Int&& b)
+  {
+    return std::move(b) + a;
+  }
 
-    const size_t a_size = a.num.d.size();
-    const size_t b_size = b.num.d.size();
-    result = (a_size <= b_size) ? mul_ordered(a.num.d, b.num.d) : mul_ordered(b.num.d, a.num.d);
-    return Nat(result);
+  Int operator+(Int&& a, Int&& b)
+  {
+    // the one with more room takes the sum
+    return (a.num.d.capacity() >= b.num.d.capacity()) ? std::move(a) + b : std::move(b) + a;
   }
 
+  Int operator-(const Int& a, const Int& b)
+  {
+    return sub(a, b);
+  }
 
-#if 0
-  Nat operator+(const Nat& a, const Nat& b)
+  Int operator-(Int&& a, const Int& b)
   {
-    return add(a, b);
+    add_signed_in_place(a.num.d, a.num.negative, b.num.d, not b.num.negative);
+    return std::move(a);
   }
-#endif
-  Nat operator*(const Nat& a, const Nat&b)
+
+  Int operator-(const Int& a, Int&& b)
+  {
+    // a - b = -(b - a)
+    add_signed_in_place(b.num.d, b.num.negative, a.num.d, not a.num.negative);
+    return -std::move(b);
+  }
+
+  Int operator-(Int&& a, Int&& b)
+  {
+    return std::move(a) - b;
+  }
+
+  Int operator-(const Int& a)
+  {
+    return Int(a.num.d, a.is_nonzero() and not a.num.negative);
+  }
+
+  Int operator-(Int&& a)
+  {
+    a.num.negative = a.is_nonzero() and not a.num.negative;
+    return std::move(a);
+  }
+
+  Int operator*(const Int& a, const Int& b)
   {
     return mul(a, b);
   }
 
+  Int operator*(Int&& a, const Int& b)
+  {
+    if (b.num_word32() > 1u)
+    {
+      return mul(a, b);
+    }
+    scale_by_word(a.num.d, b.is_zero() ? 0u : b.ls_word());
+    a.num.negative = (a.num.negative != b.num.negative) and a.is_nonzero();
+    return std::move(a);
+  }
+
+  Int operator*(const Int& a, Int&& b)
+  {
+    return std::move(b) * a;
+  }
 
-  std::pair<Nat, uint32_t> div(const Nat& n, uint32_t d)
+  Int operator*(Int&& a, Int&& b)
   {
-    const std::pair< vec32, uint32_t > temp = div(n.num.d, d);
-    return std::pair <Nat, uint32_t>(std::move(temp.first), temp.second);
+    return (b.num_word32() <= 1u) ? std::move(a) * b : std::move(b) * a;
   }
 
-  std::pair<Nat, Nat> div(const Nat& n, const Nat& d)
+  std::pair<Int, Int> div(const Int& n, const Int& d)
   {
-    if (d.num.d.size() == 1u)
+    std::pair<vec32, vec32> qr = div_vec32(n.num.d, d.num.d);
+    const bool q_negative = (n.num.negative != d.num.negative) and test_nonzero(qr.first);
+    const bool r_negative = n.num.negative and test_nonzero(qr.second);
+    return std::make_pair(Int(std::move(qr.first), q_negative), Int(std::move(qr.second), r_negative));
+  }
+
+  std::pair<Int, Int> div_floor(const Int& n, const Int& d)
+  {
+    std::pair<vec32, vec32> qr = div_vec32(n.num.d, d.num.d);
+    if ((n.num.negative == d.num.negative) or qr.second.empty())
     {
-      const std::pair< vec32, uint32_t > temp = div(n.num.d, d.num.d[0]);
-      return std::pair <Nat, Nat>(std::move(temp.first), temp.second);
+      // the truncated quotient is not negative, or is exact, so it is the same
+      const bool q_negative = (n.num.negative != d.num.negative) and test_nonzero(qr.first);
+      const bool r_negative = n.num.negative and test_nonzero(qr.second);
+      return std::make_pair(Int(std::move(qr.first), q_negative), Int(std::move(qr.second), r_negative));
     }
-    const std::pair< vec32, vec32 > temp = div_vec32(n.num.d, d.num.d);
-    return std::pair<Nat, Nat>(std::move(temp.first), std::move(temp.second));
+    // The quotient is negative and inexact: one further from zero, and the remainder
+    // |d| - |r|, which is then nonzero with the sign of d.
+    increment_by_word(qr.first, 1u);
+    vec32 r = symdiff_vec32(d.num.d, qr.second).first;
+    return std::make_pair(Int(std::move(qr.first), true), Int(std::move(r), d.num.negative));
   }
 
+  Int operator/(const Int& n, const Int& d)
+  {
+    return div(n, d).first;
+  }
 
-#if 0
-  // increment (in-place) by a value
-  void Nat_mut::increment_by(const Nat_mut& rhs)
+  Int operator/(Int&& n, const Int& d)
   {
-    vec32 result =
-      (num.d.size() <= rhs.num.d.size())
-      ? add_ordered(num.d, rhs.num.d)
-      : add_ordered(rhs.num.d, num.d);
-    num.d = result;
+    if (d.num_word32() != 1u)
+    {
+      return div(n, d).first;
+    }
+    divrem_inplace(n.num.d, d.ls_word());
+    n.num.negative = (n.num.negative != d.num.negative) and n.is_nonzero();
+    return std::move(n);
   }
 
-  // multiply (in-place) by a value
-  void Nat_mut::scale_by(const Nat_mut& rhs)
+  Int operator%(const Int& n, const Int& d)
+  {
+    return div(n, d).second;
+  }
+
+  Int operator%(Int&& n, const Int& d)
+  {
+    // the remainder of the magnitudes, with the sign of n
+    mod_in_place(n.num.d, d.num.d);
+    n.num.negative = n.num.negative and n.is_nonzero();
+    return std::move(n);
+  }
+
+  // Nat_mut
+
+  // The value goes to m_scratch, and num.d gets a buffer at least as large as its own,
+  // so neither capacity shrinks.
+  void Nat_mut::move_to_scratch()
+  {
+    m_scratch.reserve(num.d.capacity());
+    m_scratch.swap(num.d);
+  }
+
+  Nat_mut& Nat_mut::operator+=(const Nat& b)
+  {
+    increment_by_vec32(num.d, b.num.d);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator+=(const uint32_t w)
+  {
+    increment_by_word(num.d, w);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator-=(const Nat& b)
   {
-    if (num.d.size() >= rhs.num.d.size())
+    if (less_than(num.d, b.num.d))
     {
-      mul_ordered_in_place(rhs.num.d, num.d);
+      num.d.clear();
     }
     else
     {
-      vec32 result =
-        (num.d.size() <= rhs.num.d.size())
-        ? mul_ordered(num.d, rhs.num.d)
-        : mul_ordered(rhs.num.d, num.d);
-      num.d = result;
+      decrement_by_vec32(num.d, b.num.d);
     }
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator-=(const uint32_t w)
+  {
+    if (num.d.empty() or ((num.d.size() == 1u) and (num.d[0] < w)))
+    {
+      num.d.clear();
+    }
+    else
+    {
+      decrement_by_word(num.d, w);
+    }
+    return *this;
+  }
+
+  // num.d = num.d * b, with the product written over num.d from a copy in m_scratch
+  void Nat_mut::multiply_by(const vec32& b)
+  {
+    if (b.size() <= 1u)
+    {
+      scale_by_word(num.d, b.empty() ? 0u : b[0]);
+      return;
+    }
+    if (num.d.empty())
+    {
+      return;
+    }
+    const bool square = (&b == &num.d);
+    move_to_scratch();
+    const size_t an = m_scratch.size();
+    const size_t bn = square ? an : b.size();
+    num.d.resize(an + bn);
+    const size_t n = square ? sqr_vec32(num.d.data(), m_scratch.data(), an, m_ws)
+                            : mul_vec32(num.d.data(), m_scratch.data(), an, b.data(), bn, m_ws);
+    num.d.resize(n);
+  }
+
+  Nat_mut& Nat_mut::operator*=(const Nat& b)
+  {
+    multiply_by(b.num.d);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator*=(const uint32_t w)
+  {
+    scale_by_word(num.d, w);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator/=(const Nat& d)
+  {
+    const size_t nn = num.d.size();
+    const size_t dn = d.num_word32();
+    if ((dn == 0u) || (nn < dn))
+    {
+      num.d.clear();
+    }
+    else if (dn == 1u)
+    {
+      divrem_inplace(num.d, d.ls_word());
+    }
+    else
+    {
+      // the quotient goes in num.d, and the unwanted remainder over the copy of n in m_scratch
+      move_to_scratch();
+      num.d.resize(nn - dn + 1u);
+      const std::pair<size_t, size_t> sizes = divrem_n(num.d.data(), m_scratch.data(), m_scratch.data(), nn,
+                                                       d.num.d.data(), dn, m_ws.reserve(div_scratch_size(nn, dn)));
+      num.d.resize(sizes.first);
+    }
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator/=(const uint32_t w)
+  {
+    divrem_inplace(num.d, w);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator%=(const Nat& d)
+  {
+    const size_t nn = num.d.size();
+    const size_t dn = d.num_word32();
+    if ((dn <= 1u) || (nn < dn))
+    {
+      mod_in_place(num.d, d.num.d);
+    }
+    else
+    {
+      // the remainder is written over num.d, and the unwanted quotient goes in the workspace
+      const size_t qn = nn - dn + 1u;
+      uint32_t* const q = m_ws.reserve(qn + div_scratch_size(nn, dn));
+      const std::pair<size_t, size_t> sizes = divrem_n(q, num.d.data(), num.d.data(), nn, d.num.d.data(), dn, q + qn);
+      num.d.resize(sizes.second);
+    }
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator%=(const uint32_t w)
+  {
+    const uint32_t r = (w == 0u) ? 0u : Word_divisor(w).mod(num.d.data(), num.d.size());
+    num.d.assign((r != 0u) ? 1u : 0u, r);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator<<=(const size_t bits)
+  {
+    const size_t n = num.d.size();
+    if (n == 0u)
+    {
+      return *this;
+    }
+    const size_t words = bits / 32u;
+    num.d.resize(n + words + 1u);
+    uint32_t* const d = num.d.data();
+    std::copy_backward(d, d + n, d + n + words);
+    std::fill(d, d + words, 0u);
+    d[n + words] = lshift_n(d + words, d + words, n, unsigned(bits % 32u));
+    remove_MSW_zeros(num.d);
+    return *this;
+  }
+
+  Nat_mut& Nat_mut::operator>>=(const size_t bits)
+  {
+    const size_t words = bits / 32u;
+    if (words >= num.d.size())
+    {
+      num.d.clear();
+      return *this;
+    }
+    uint32_t* const d = num.d.data();
+    const size_t n = num.d.size() - words;
+    std::copy(d + words, d + words + n, d);
+    rshift_n(d, d, n, unsigned(bits % 32u));
+    num.d.resize(normalized_size(d, n));
+    return *this;
+  }
+
+  // increment (in-place) by a value
+  void Nat_mut::increment_by(const Nat_mut& rhs)
+  {
+    increment_by_vec32(num.d, rhs.num.d);
+  }
+
+  // multiply (in-place) by a value
+  void Nat_mut::scale_by(const Nat_mut& rhs)
+  {
+    multiply_by(rhs.num.d);
   }
-#endif
 
 
 } // end namespace Big_numbers
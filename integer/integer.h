@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <ostream>
 #include <utility>
+#include <iterator>
 #include <iso646.h>   // so "not" 'or" and "and" work, VSC++ bug
 //#include <iostream> // for debug cout <<
 
@@ -30,17 +31,78 @@ namespace Big_numbers {
   void increment_by_word(std::vector<uint32_t>& n, const uint32_t delta);
 
   // symmetric difference of two naturals (in vec32 format).
-  // The second value of the result has the value less_than_or_equal(a,b)
+  // The second value of the result has the value greater_than(a,b),
+  // so it is true when the first value is a-b, and false when it is b-a.
   std::pair< std::vector<uint32_t>, bool> symdiff_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
 
+  // mul_vec32(a, a), with a the same object, is done as sqr_vec32(a).
   std::vector<uint32_t> mul_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
 
+  // a*a, computing each cross product a[i]*a[j] once and doubling the sum.
+  std::vector<uint32_t> sqr_vec32(const std::vector<uint32_t>& a);
+
   // div takes a numerator n and a divisor d, returns a pair (quotient, remainder).
+  // Uses Knuth's Algorithm D, so each quotient word needs one multiply-subtract pass.
   std::pair< std::vector<uint32_t>, std::vector<uint32_t> > div_vec32(const std::vector<uint32_t>& n, const std::vector<uint32_t>& d);
 
 
   std::vector<uint32_t> mul_vec32_by_word(const std::vector<uint32_t>& a, const uint32_t b);
 
+  // Reusable scratch memory for the functions below that write to caller provided
+  // ranges instead of returning a new vector.  Each of them grows the workspace if
+  // it is too small, so a workspace made with the largest *_scratch_size() that a
+  // loop needs is never reallocated, and the loop does no heap allocation.
+  // (The Toom-Cook and NTT multiplies, above TOOM3_THRESHOLD, still allocate their
+  // own temporaries.  That is small compared to the work they do.)
+  class Workspace
+  {
+  public:
+    Workspace() {}
+    explicit Workspace(const size_t words) : m_words(words) {}
+
+    // returns at least the given number of words, valid until the next reserve()
+    uint32_t* reserve(const size_t words)
+    {
+      if (m_words.size() < words)
+      {
+        m_words.resize(words);
+      }
+      return m_words.data();
+    }
+
+    size_t size() const noexcept { return m_words.size(); }
+
+  private:
+    std::vector<uint32_t> m_words;
+  };
+
+  // The operands are ranges in vec32 format (LSW first, MSW nonzero), and the
+  // functions return the size of the (normalized) result written to the output range.
+  // An output range must not overlap an operand.
+
+  // r[0..max(an,bn)] = a + b.  Needs no workspace.
+  size_t add_vec32(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn) noexcept;
+
+  // r[0..an+bn) = a * b, writes all an+bn words.
+  size_t mul_scratch_size(const size_t asize, const size_t bsize) noexcept;
+  size_t mul_vec32(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn, Workspace& ws);
+
+  // r[0..2n) = a * a, writes all 2n words.
+  size_t sqr_scratch_size(const size_t n) noexcept;
+  size_t sqr_vec32(uint32_t* r, const uint32_t* a, const size_t n, Workspace& ws);
+
+  // q[0..nn-dn+1) = n / d and r[0..dn) = n % d, returns the sizes of (q, r).
+  // Returns (0,0) if d is zero, like div_vec32.  If nn < dn, q is not written.
+  size_t div_scratch_size(const size_t nsize, const size_t dsize) noexcept;
+  std::pair<size_t, size_t> div_vec32(uint32_t* q, uint32_t* r, const uint32_t* n, const size_t nn,
+                                      const uint32_t* d, const size_t dn, Workspace& ws);
+
+  // In-place divisions, which reuse the memory of their arguments.
+  // n = n / d, returns n % d.  If d is zero, n = 0 and returns 0.
+  uint32_t divrem_inplace(std::vector<uint32_t>& n, const uint32_t d);
+  // q = n / d, n = n % d.  If d is zero, both are set to 0.
+  void divrem_inplace(std::vector<uint32_t>& n, const std::vector<uint32_t>& d, std::vector<uint32_t>& q, Workspace& ws);
+
   struct To_infinity {};  // phantom type for constructing numbers with +-infinity
 
 
@@ -87,9 +149,9 @@ namespace Big_numbers {
     */
 
     std::vector < std::uint32_t > d;   // [0] is LSBs, last is MSBs. Empty for zero
-    const bool negative = { false };
-    const bool infinite = { false };
-    const bool NaN = { false };
+    bool negative = { false };
+    bool infinite = { false };
+    bool NaN = { false };
 
 
     // special values:  +inf,-inf, -0, NaN
@@ -131,7 +193,7 @@ namespace Big_numbers {
       , NaN(rhs.NaN)
     {}
 
-    Integral_number(Integral_number&& rhs)
+    Integral_number(Integral_number&& rhs) noexcept
       : d(std::move(rhs.d))
       , negative(rhs.negative)
       , infinite(rhs.infinite)
@@ -139,6 +201,9 @@ namespace Big_numbers {
     {
     }
 
+    Integral_number& operator=(const Integral_number& rhs) = default;
+    Integral_number& operator=(Integral_number&& rhs) = default;
+
     explicit Integral_number(const std::vector<uint32_t>& value)
       : d(value)
       , negative(false)
@@ -146,13 +211,13 @@ namespace Big_numbers {
       , NaN(false)
     {}
 
-    explicit Integral_number(const std::vector<uint32_t>&& value)
+    // takes the words of value, without copying them
+    explicit Integral_number(std::vector<uint32_t>&& value) noexcept
       : d(std::move(value))
-
-
-    {
-      //std::cout << "Integral_number move constructor called, size=" << d.size() << std::endl;
-    }
+      , negative(false)
+      , infinite(false)
+      , NaN(false)
+    {}
 
     Integral_number(const std::vector<uint32_t>& value, const bool negate)
       : d(value)
@@ -161,8 +226,12 @@ namespace Big_numbers {
       ,NaN(false)
     {}
 
-    Integral_number(const std::vector<uint32_t>&& value, const bool negate)
-      : d(value), negative(negate), infinite(false) {}
+    Integral_number(std::vector<uint32_t>&& value, const bool negate) noexcept
+      : d(std::move(value))
+      , negative(negate)
+      , infinite(false)
+      , NaN(false)
+    {}
 
 
     explicit Integral_number(const uint32_t w)
@@ -214,30 +283,28 @@ namespace Big_numbers {
 
     Nat(const Nat& n) : num(n.num)
     { }
-    Nat(const Nat&& n) : num(std::move(n.num))
+    Nat(Nat&& n) noexcept : num(std::move(n.num))
     { }
 
+    Nat& operator=(const Nat& n) = default;
+    Nat& operator=(Nat&& n) = default;
+
     // make a natural number from a list from lsb to msb (msb pushed last).
     explicit Nat(const std::vector<uint32_t>& value)
       : num(value) {}
 
-    // make a natural number from a list from lsb to msb (msb pushed last).
-    Nat(const std::vector<uint32_t>&& value)
-      : num(value)
+    // make a natural number from a list from lsb to msb (msb pushed last),
+    // taking its words without copying them.
+    Nat(std::vector<uint32_t>&& value) noexcept
+      : num(std::move(value))
     {
-      //std::cout << "Nat move constructor called, size=" << num.d.size() << std::endl;
     }
 
     explicit Nat(const std::uint32_t w) : num(w) {}
 
-    Nat operator+(const Nat& b) const
-    {
-      return Nat(add_vec32(num.d, b.num.d));
-    }
-
-    Nat operator*(const Nat&b) const
+    Nat square() const
     {
-      return Nat(mul_vec32(num.d, b.num.d));
+      return Nat(sqr_vec32(num.d));
     }
 
 
@@ -268,7 +335,7 @@ namespace Big_numbers {
       return (*this > rhs) || (*this == rhs);
     }
 
-    const Integral_number num;  // use this if you want to go low_level.
+    Integral_number num;  // use this if you want to go low_level, keeping its invariants.
 
     size_t num_word32() const noexcept { return num.d.size(); }
 
@@ -284,15 +351,312 @@ namespace Big_numbers {
 
 
   Nat add(const Nat& a, const Nat& b);
-  //Nat operator+(const Nat& a, const Nat& b);  // for some reason, unable to inline this
-
   Nat mul(const Nat& a, const Nat& b);
 
+  // The operators give the result the words of an operand that is about to expire:
+  // + and - work in place on it, like increment_by_word, and * and / by one word
+  // like scale_by_word, so a + b + c and x * y + z allocate only for the products
+  // and when a sum outgrows its words.  Nat has no negative values, so a - b is 0
+  // if b > a.  / and % are quot and mod.
+  Nat operator+(const Nat& a, const Nat& b);
+  Nat operator+(Nat&& a, const Nat& b);
+  Nat operator+(const Nat& a, Nat&& b);
+  Nat operator+(Nat&& a, Nat&& b);
+  Nat operator-(const Nat& a, const Nat& b);
+  Nat operator-(Nat&& a, const Nat& b);
+  Nat operator-(const Nat& a, Nat&& b);
+  Nat operator-(Nat&& a, Nat&& b);
+  Nat operator*(const Nat& a, const Nat& b);
+  Nat operator*(Nat&& a, const Nat& b);
+  Nat operator*(const Nat& a, Nat&& b);
+  Nat operator*(Nat&& a, Nat&& b);
+  Nat operator/(const Nat& n, const Nat& d);
+  Nat operator/(Nat&& n, const Nat& d);
+  Nat operator%(const Nat& n, const Nat& d);
+  Nat operator%(Nat&& n, const Nat& d);
+
+  // A mutable natural number, for accumulators such as sums of many terms and
+  // running products.  The compound assignments work in its own words, with a
+  // scratch vector and workspace of its own for the products and quotients, and
+  // none of them ever shrinks: once they have grown to the sizes a loop needs,
+  // the loop does no allocation.  Making one from a Nat rvalue, and to_nat() on
+  // an rvalue, move the words.  As for Nat, x -= y gives 0 if y > x, and dividing
+  // by 0 gives 0.
+  struct Nat_mut {
+
+    Nat_mut() : num(uint32_t(0)) {}
+
+    explicit Nat_mut(const uint32_t w) : num(w) {}
+
+    explicit Nat_mut(const Nat& n) : num(n.num) {}
+
+    Nat_mut(Nat&& n) noexcept : num(std::move(n.num)) {}
+
+    Nat to_nat() const & { return Nat(num.d); }
+    Nat to_nat() && { return Nat(std::move(num.d)); }  // leaves this 0
+
+    // room for a value of this many words without reallocating
+    void reserve(const size_t words) { num.d.reserve(words); }
+    size_t capacity() const noexcept { return num.d.capacity(); }
+
+    Nat_mut& operator+=(const Nat& b);
+    Nat_mut& operator+=(const uint32_t w);
+    Nat_mut& operator-=(const Nat& b);
+    Nat_mut& operator-=(const uint32_t w);
+    Nat_mut& operator*=(const Nat& b);
+    Nat_mut& operator*=(const uint32_t w);
+    Nat_mut& operator/=(const Nat& d);
+    Nat_mut& operator/=(const uint32_t w);
+    Nat_mut& operator%=(const Nat& d);
+    Nat_mut& operator%=(const uint32_t w);
+    Nat_mut& operator<<=(const size_t bits);
+    Nat_mut& operator>>=(const size_t bits);
+
+    // increment (in-place) by a value
+    void increment_by(const Nat_mut& rhs);
+    // multiply (in-place) by a value
+    void scale_by(const Nat_mut& rhs);
+
+    bool operator == (const Nat& rhs) const { return (rhs.num.d == num.d); }
+    bool operator != (const Nat& rhs) const { return (rhs.num.d != num.d); }
+
+    Integral_number num;  // use this if you want to go low_level, keeping its invariants.
+
+    size_t num_word32() const noexcept { return num.d.size(); }
+    bool is_nonzero() const noexcept { return (num.d.size() != 0u); }
+    bool is_zero() const noexcept { return (num.d.size() == 0u); }
+
+  private:
+    void multiply_by(const std::vector<uint32_t>& b);
+    void move_to_scratch();
+
+    std::vector<uint32_t> m_scratch;
+    Workspace m_ws;
+  };  //end Nat_mut
+
 
   // euclidean division, not defined if d=0, will return (0,0) for quotient and remainder
   std::pair<Nat, uint32_t> div(const Nat& n, uint32_t d);
   std::pair<Nat, Nat> div(const Nat& n, const Nat& d);
 
+  // The reciprocal of a divisor, for dividing many numbers by the same divisor,
+  // as in radix conversion or reducing modulo one large number.
+  // It is made once with Newton's iteration, then div(n, reciprocal) for n up to
+  // twice the size of the divisor costs about two multiplies (Barrett's method).
+  // Divisors of less than RECIPROCAL_THRESHOLD words just use div(n, d).
+  class Reciprocal
+  {
+  public:
+    explicit Reciprocal(const Nat& d);
+
+    const Nat& divisor() const noexcept { return m_divisor; }
+
+  private:
+    friend std::pair<Nat, Nat> div(const Nat& n, const Reciprocal& d);
+
+    Nat m_divisor;
+    unsigned m_shift;                    // so the MSW of m_normalized has its top bit set
+    std::vector<uint32_t> m_normalized;  // m_divisor << m_shift
+    std::vector<uint32_t> m_inverse;     // floor(2**(64*size) / m_normalized)
+  };
+
+  // same (quotient, remainder) as div(n, d.divisor())
+  std::pair<Nat, Nat> div(const Nat& n, const Reciprocal& d);
+
+  // A one word divisor with a precomputed reciprocal (Moller and Granlund,
+  // "Improved division by invariant integers"), so each word of a division
+  // costs two multiplies instead of a hardware 64 by 32 bit divide.
+  // div(n, uint32_t d) makes one of these, keep it to divide many numbers by d.
+  class Word_divisor
+  {
+  public:
+    explicit Word_divisor(const uint32_t d) noexcept;
+
+    uint32_t divisor() const noexcept { return m_divisor; }
+
+    // q[0..n) = a[0..n) / divisor(), returns the remainder.  q may be the same as a.
+    // precondition: divisor() != 0
+    uint32_t divrem(uint32_t* q, const uint32_t* a, const size_t n) const noexcept;
+
+    // returns a[0..n) % divisor(), the same pass as divrem without storing the quotient.
+    // precondition: divisor() != 0
+    uint32_t mod(const uint32_t* a, const size_t n) const noexcept;
+
+  private:
+    friend void divisible_by(const Nat& n, const Word_divisor* divisors, const size_t count, bool* results) noexcept;
+
+    uint32_t div_2by1(const uint32_t u1, const uint32_t u0, uint32_t& remainder) const noexcept;
+
+    uint32_t m_divisor;
+    uint32_t m_normalized;  // m_divisor << m_shift, has its top bit set
+    uint32_t m_inverse;     // floor((2**64 - 1) / m_normalized) - 2**32
+    unsigned m_shift;
+  };
+
+  // same (quotient, remainder) as div(n, d.divisor())
+  std::pair<Nat, uint32_t> div(const Nat& n, const Word_divisor& d);
+
+  // Only the remainder, or only the quotient, of div(n, d), without making the other one.
+  // Like div, they give 0 if d is zero.
+  Nat mod(const Nat& n, const Nat& d);
+  uint32_t mod(const Nat& n, const uint32_t d);
+  uint32_t mod(const Nat& n, const Word_divisor& d);
+  Nat quot(const Nat& n, const Nat& d);
+  Nat quot(const Nat& n, const uint32_t d);
+
+  // n / d, when d is known to divide n.  The result is undefined if it does not.
+  // They work from the LSW with the inverse of d modulo 2**32 (Jebelean's exact
+  // division), so there are no trial quotients and no remainder to keep.
+  Nat divexact(const Nat& n, const Nat& d);
+  Nat divexact(const Nat& n, const uint32_t d);
+
+  // true if d divides n, without returning a quotient.  0 divides only 0.
+  // The one word version is one pass from the LSW with the inverse of d modulo 2**32.
+  // For a d of more words the division still needs room for the quotient, the
+  // remainder and the scratch, which the version without a workspace allocates on
+  // every call.  Pass the same Workspace to screen many numbers without allocating.
+  bool divisible_by(const Nat& n, const uint32_t d) noexcept;
+  bool divisible_by(const Nat& n, const Nat& d);
+  bool divisible_by(const Nat& n, const Nat& d, Workspace& ws);
+  // results[i] = divisible_by(n, divisors[i].divisor()) for i in [0, count).
+  // One pass over the words of n updates the remainders of many divisors,
+  // such as a table of small primes made once.
+  void divisible_by(const Nat& n, const Word_divisor* divisors, const size_t count, bool* results) noexcept;
+
+  // Arithmetic modulo an odd m in Montgomery form (Montgomery, "Modular multiplication
+  // without trial division").  A residue x is held as x*R mod m, where R = 2**(32*size()).
+  // A product is reduced by adding the multiple of m that clears its low size() words,
+  // then dropping them, so there is no division.  This is the SOS order: multiply with
+  // the usual algorithms (Karatsuba and up), then reduce a word at a time, or for
+  // large moduli with two more multiplies.
+  // The change into and out of Montgomery form costs a division, so do it only at the
+  // start and the end of a long computation such as a modular exponentiation.
+  class Mod_context
+  {
+  public:
+    // precondition: m is odd
+    explicit Mod_context(const Nat& m);
+
+    const Nat& modulus() const noexcept { return m_modulus; }
+    size_t size() const noexcept { return m_modulus.num_word32(); }
+
+    // The operations on residues, which are ranges of exactly size() words (with
+    // leading zeros kept) less than the modulus.  r may be the same as an operand.
+    // mul and sqr need scratch_size() words of workspace.
+    size_t scratch_size() const noexcept;
+    // r = a*b/R mod m
+    void mul(uint32_t* r, const uint32_t* a, const uint32_t* b, Workspace& ws) const;
+    // r = a*a/R mod m
+    void sqr(uint32_t* r, const uint32_t* a, Workspace& ws) const;
+    // r = x*R mod m, for any x in vec32 format, into Montgomery form
+    void to_montgomery(uint32_t* r, const uint32_t* x, const size_t xn, Workspace& ws) const;
+    // r = a/R mod m, out of Montgomery form
+    void from_montgomery(uint32_t* r, const uint32_t* a, Workspace& ws) const;
+
+  private:
+    void reduce(uint32_t* r, uint32_t* t, uint32_t* scratch) const;
+
+    Nat m_modulus;
+    uint32_t m_inverse;                // -1/m mod 2**32
+    std::vector<uint32_t> m_inverse_n;  // -1/m mod R, from MONTGOMERY_REDC_N_THRESHOLD
+  };
+
+  // A residue modulo context().modulus() in Montgomery form.  The context must outlive it,
+  // and both operands of a multiply must have the same context.
+  // Each operation makes a new residue.  For loops with no allocation, use the Mod_context
+  // operations on ranges.
+  class Mont_nat
+  {
+  public:
+    // x mod m, into Montgomery form
+    Mont_nat(const Nat& x, const Mod_context& context);
+
+    const Mod_context& context() const noexcept { return *m_context; }
+
+    // out of Montgomery form, the value in [0, m)
+    Nat to_nat() const;
+
+    Mont_nat operator*(const Mont_nat& b) const;
+    Mont_nat& operator*=(const Mont_nat& b);
+    Mont_nat square() const;
+
+    bool operator == (const Mont_nat& rhs) const { return (m_value == rhs.m_value); }
+    bool operator != (const Mont_nat& rhs) const { return (m_value != rhs.m_value); }
+
+  private:
+    const Mod_context* m_context;
+    std::vector<uint32_t> m_value;  // context().size() words
+  };
+
+  // Reduction modulo any m > 0 by Barrett's method (Handbook of Applied Cryptography,
+  // 14.42), for moduli that Mod_context cannot take, such as even ones.
+  // With mu = floor(2**(64*size()) / m) made once by a division, the quotient of an
+  // x < m*m is estimated from the top words of (the top of x) * mu.  It is at most
+  // 3 too small, because the smaller sizes leave out the low words of the first
+  // multiply, so a reduction is two multiplies and at most three subtractions of m.
+  // Residues are not changed into another form, unlike Mod_context.
+  class Barrett_context
+  {
+  public:
+    // precondition: m != 0
+    explicit Barrett_context(const Nat& m);
+
+    const Nat& modulus() const noexcept { return m_modulus; }
+    size_t size() const noexcept { return m_modulus.num_word32(); }
+
+    // The operations on residues, which are ranges of exactly size() words (with
+    // leading zeros kept) less than the modulus.  r may be the same as an operand.
+    // mul and sqr need scratch_size() words of workspace.
+    size_t scratch_size() const noexcept;
+    // r = a*b mod m
+    void mul(uint32_t* r, const uint32_t* a, const uint32_t* b, Workspace& ws) const;
+    // r = a*a mod m
+    void sqr(uint32_t* r, const uint32_t* a, Workspace& ws) const;
+
+  private:
+    void reduce(uint32_t* r, const uint32_t* x, uint32_t* scratch) const;
+
+    Nat m_modulus;
+    std::vector<uint32_t> m_mu;  // floor(2**(64*size()) / m), in vec32 format
+  };
+
+  // a*b mod m.  Like div, they give 0 if m is zero.
+  // Keep a Barrett_context for many products modulo the same m.
+  Nat mulmod(const Nat& a, const Nat& b, const Nat& m);
+  Nat mulmod(const Nat& a, const Nat& b, const Barrett_context& m);
+
+  // base**exp, with 0**0 = 1.  The size of the result is known at the start, so the
+  // squares and multiplies (left to right binary) go back and forth between two buffers
+  // of that size.  The power of two in base is taken out first and becomes a shift.
+  // Throws std::length_error if the result could not fit in memory.
+  Nat pow(const Nat& base, const uint64_t exp);
+
+  // base**exp mod m, by sliding window exponentiation with a table of odd powers of base,
+  // its window chosen from the length of exp.  Like div, they give 0 if m is zero,
+  // and base**0 is 1.  The Nat version uses a Mod_context for an odd m and a
+  // Barrett_context for an even one.  Keep a context for many powers modulo the same m.
+  Nat powmod(const Nat& base, const Nat& exp, const Nat& m);
+  Nat powmod(const Nat& base, const Nat& exp, const Mod_context& m);
+  Nat powmod(const Nat& base, const Nat& exp, const Barrett_context& m);
+
+  // The greatest common divisor, with gcd(n, 0) = n.
+  // Lehmer's algorithm does the work while both are at least GCD_LEHMER_THRESHOLD words:
+  // the leading two words of a and b give the cofactors for many steps of Euclid's
+  // algorithm, which are then done on all of a and b in one pass.  Smaller ones finish
+  // with the binary gcd.  The work is done in place on copies of a and b.
+  // From GCD_HGCD_THRESHOLD words the half gcd first reduces them, in O(M(n) log n) time.
+  Nat gcd(const Nat& a, const Nat& b);
+
+  // The working memory of gcd, gcdext and invmod.  Passing the same one to many calls,
+  // such as the inverses of many residues, lets them reuse it instead of allocating.
+  struct Gcd_workspace
+  {
+    std::vector<uint32_t> remainders;    // the Lehmer steps, 4 * (max(an, bn) + 1) words
+    std::vector<uint32_t> cofactors[2];  // the cofactors of a, for gcdext and invmod
+    Workspace division;                  // the quotients and scratch of the divisions
+  };
+  Nat gcd(const Nat& a, const Nat& b, Gcd_workspace& ws);
+
 
   // an Int is your classical negate(nonzeroNat) | zero | nonzeroNat
   // no NaN or +inf or -inf
@@ -304,10 +668,13 @@ namespace Big_numbers {
 
     Int(const Int& n) : num(n.num)
     { }
-    Int(const Int&& n) : num(n.num)
+    Int(Int&& n) noexcept : num(std::move(n.num))
     { }
 
-    Int(const Nat&& nat) : num(std::move(nat.num)) {};
+    Int& operator=(const Int& n) = default;
+    Int& operator=(Int&& n) = default;
+
+    Int(Nat&& nat) noexcept : num(std::move(nat.num)) {};
 
     // make a natural number from a list from lsb to msb (msb pushed last).
     explicit Int(const std::vector<uint32_t>& value, bool isNegative)
@@ -315,14 +682,16 @@ namespace Big_numbers {
     {
     }
 
-    // make Int from a list from lsb to msb (msb pushed last).
-    Int(const std::vector<uint32_t>&& value, bool isNegative)
-      : num(value, isNegative)
+    // make Int from a list from lsb to msb (msb pushed last), taking its words without copying them.
+    Int(std::vector<uint32_t>&& value, bool isNegative) noexcept
+      : num(std::move(value), isNegative)
     {
-      //std::cout << "Int move constructor called, size=" << num.d.size() << std::endl;
     }
 
-    explicit Int(const std::int32_t w) : num(uint32_t(w < 0 ? w : -w), w < 0) {}
+    explicit Int(const std::int32_t w)
+      : num((w == 0) ? std::vector<uint32_t>() : std::vector<uint32_t>(1u, (w < 0) ? 0u - uint32_t(w) : uint32_t(w)),
+            w < 0)
+    {}
 
     bool operator == (const Int& rhs) const
     {
@@ -361,18 +730,70 @@ namespace Big_numbers {
       return (*this > rhs) || (*this == rhs);
     }
 
-    const Integral_number num;  // use this if you want to go low_level.
+    Integral_number num;  // use this if you want to go low_level, keeping its invariants.
 
     size_t num_word32() const noexcept { return num.d.size(); }
     uint32_t get_word(size_t i) const noexcept { return i < num_word32() ? num.d[i] : 0; }
     uint32_t ls_word() const noexcept { return num.d[0]; }
     uint32_t ms_word() const noexcept { return num.d[num_word32() - 1u]; }
 
-    bool is_nonzero() const noexcept { return (num.d.back() != 0u); }
-    bool is_zero() const noexcept { return (num.d.back() == 0u); }
+    bool is_nonzero() const noexcept { return (num.d.size() != 0u); }
+    bool is_zero() const noexcept { return (num.d.size() == 0u); }
 
   };  //end Int
 
+  // Signed arithmetic.  The signs choose add_vec32 or symdiff_vec32 for the magnitudes,
+  // and mul_vec32 and div_vec32 do the rest.  Zero is never negative.
+  // As for Nat, the operators reuse the words of an operand that is about to expire.
+  Int add(const Int& a, const Int& b);
+  Int sub(const Int& a, const Int& b);
+  Int mul(const Int& a, const Int& b);
+  Int operator+(const Int& a, const Int& b);
+  Int operator+(Int&& a, const Int& b);
+  Int operator+(const Int& a, Int&& b);
+  Int operator+(Int&& a, Int&& b);
+  Int operator-(const Int& a, const Int& b);
+  Int operator-(Int&& a, const Int& b);
+  Int operator-(const Int& a, Int&& b);
+  Int operator-(Int&& a, Int&& b);
+  Int operator-(const Int& a);
+  Int operator-(Int&& a);
+  Int operator*(const Int& a, const Int& b);
+  Int operator*(Int&& a, const Int& b);
+  Int operator*(const Int& a, Int&& b);
+  Int operator*(Int&& a, Int&& b);
+
+  // Truncating division, as for the built in integer types: the quotient is rounded
+  // toward zero and a nonzero remainder has the sign of n.  / and % are its two halves.
+  // Floor division rounds the quotient down, so a nonzero remainder has the sign of d.
+  // As for Nat, dividing by 0 gives (0, 0).
+  std::pair<Int, Int> div(const Int& n, const Int& d);
+  std::pair<Int, Int> div_floor(const Int& n, const Int& d);
+  Int operator/(const Int& n, const Int& d);
+  Int operator/(Int&& n, const Int& d);
+  Int operator%(const Int& n, const Int& d);
+  Int operator%(Int&& n, const Int& d);
+
+  // g = gcd(a, b) = s*a + t*b.  The cofactors are those of Euclid's algorithm, so
+  // |s| <= b/g and |t| <= a/g if a and b are nonzero.  gcdext(a, 0) is (a, 1, 0)
+  // and gcdext(0, b) is (b, 0, 1).
+  // The steps are those of gcd, with only the cofactor of a kept along, and t found
+  // at the end as (g - s*a)/b.
+  struct Gcdext_result
+  {
+    Nat g;
+    Int s;
+    Int t;
+  };
+  Gcdext_result gcdext(const Nat& a, const Nat& b);
+  Gcdext_result gcdext(const Nat& a, const Nat& b, Gcd_workspace& ws);
+
+  // The inverse of a modulo m, in [0, m): (true, x) with a*x = 1 (mod m), or (false, 0)
+  // if gcd(a, m) is not 1 or m is 0.  It is the cofactor of a from gcdext(a, m),
+  // without t, so with a workspace the only allocation is the result.
+  std::pair<bool, Nat> invmod(const Nat& a, const Nat& m);
+  std::pair<bool, Nat> invmod(const Nat& a, const Nat& m, Gcd_workspace& ws);
+
     // test for a < b, where a and b are vector<uint32_t>
   bool less_than(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs) noexcept;
   // multiply a vector of words by a word, in-place
@@ -388,36 +809,146 @@ namespace Big_numbers {
   std::vector<uint32_t> add_vec32(const std::vector<uint32_t>& a, const std::vector<uint32_t>&b);
   std::vector<uint32_t> mul_old_fashioned(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
   std::vector<uint32_t> mul_conv(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+  // The long division div_vec32 used before Knuth's Algorithm D, which estimates
+  // each quotient word and repeats until the remainder is less than d.
+  // Slower, kept as a reference for testing div_vec32.
+  std::pair< std::vector<uint32_t>, std::vector<uint32_t> > div_old_fashioned(const std::vector<uint32_t>& n, const std::vector<uint32_t>& d);
 
-  // pre-condition: operands almost the same size,  a.size <= b.size <= a.size+1
+  // pre-condition: operands roughly the same size,  a.size <= b.size <= 2*a.size
   // recursively performs divide and conquer, until a.size <= KARATSUBA_THESHOLD,
   // then just calls a nonrecursive multiply.
   // because halves the size, will recurse at most 64 times, but actually less 
   // because of the threshold transitions to non-recursive.
   // TODO develop on vec32, then change to be a templated (over the iterator class)
   // return false if the invariant was violated.
-  // out_iter probably should have reserved (asize + bsize) words.
+  // out_iter must point to (asize + bsize) writable words, all of which are written.
+  // Unlike the vec32 functions, the result may have a zero MSW.
+  // mul_vec32 and Nat::operator* use this automatically for large enough operands.
   const size_t KARATSUBA_THRESHOLD = 40u;
+  // Above these sizes (of the shorter operand) mul_vec32 switches from Karatsuba
+  // to the Toom-Cook 3-way and then 4-way multiplies.  The evaluation and
+  // interpolation are done with add_vec32, symdiff_vec32 and div by a word.
+  const size_t TOOM3_THRESHOLD = 600u;
+  const size_t TOOM4_THRESHOLD = 2000u;
+  // sqr_vec32 uses the elementary-school square up to this size, then Karatsuba.
+  // Squaring the Toom and NTT sizes uses the same thresholds as the multiplies.
+  const size_t SQR_KARATSUBA_THRESHOLD = 60u;
+  // Above this size mul_vec32 uses a number-theoretic transform multiply
+  // (three primes, recombined with the Chinese remainder theorem).
+  // The transforms limit a product to 2**24 words; larger products use Toom-4
+  // whose sub-products are again done with the transforms.
+  const size_t NTT_THRESHOLD = 24000u;
+  // Above this size (of both the divisor and the quotient) div_vec32 uses the
+  // Burnikel-Ziegler recursive division, which does its work with mul_vec32.
+  const size_t BURNIKEL_ZIEGLER_THRESHOLD = 60u;
+  // Below this divisor size, div(n, Reciprocal) is not faster than div(n, d),
+  // so a Reciprocal just keeps the divisor.
+  const size_t RECIPROCAL_THRESHOLD = 4000u;
+  // From this modulus size Mod_context reduces with two multiplies by the inverse
+  // of m modulo R, instead of a word at a time.
+  const size_t MONTGOMERY_REDC_N_THRESHOLD = 200u;
+  // gcd uses Lehmer's algorithm from this size, and the binary gcd below it.
+  const size_t GCD_LEHMER_THRESHOLD = 4u;
+  // From this size gcd uses the half gcd, which recurses down to HGCD_THRESHOLD.
+  const size_t GCD_HGCD_THRESHOLD = 2000u;
+  const size_t HGCD_THRESHOLD = 300u;
   bool mul_Karatsuba(std::vector<uint32_t>::const_iterator abegin, std::vector<uint32_t>::const_iterator aend,
                                       std::vector<uint32_t>::const_iterator bbegin, std::vector<uint32_t>::const_iterator bend,
-                                      std::vector<uint32_t> out_iter);
+                                      std::vector<uint32_t>::iterator out_iter);
+
+  // A lazy version of mul_Karatsuba, for operands of any sizes.
+  // Like Product_generator in arithmetic_algorithm.h, begin() and end() give a
+  // forward iterator that returns the product from LSW to MSW.  If the product
+  // is zero begin()==end(), otherwise the last word returned is the nonzero MSW.
+  //
+  // The operands are cut into blocks of PROD_GENERATOR_BLOCK_SIZE words (the last
+  // block zero padded).  The block products on diagonal k (blocks i and j with i+j==k)
+  // are done with the Karatsuba multiply and summed into a window of the result.
+  // After diagonal k is summed the low block of the window is final, and its
+  // words are returned one at a time.  So an iterator owns a fixed amount of memory,
+  // about 10 blocks, whatever the size of the product, and allocates it only when made.
+  // The time is that of (asize/B)*(bsize/B) Karatsuba multiplies of B words.
+  //
+  // The operands must not change or be destroyed while an iterator is in use.
+  const size_t PROD_GENERATOR_BLOCK_SIZE = 256u;
 
-  // A lazy version of mul_Karatsuba, with same pre-condition
-  // Need to pass abegin(), aend(), bbegin(), bend(), each call returns one word of result.
-  // TODO implement using the below signature, then 
   class Prod_Karatsuba_generator
   {
+  public:
     Prod_Karatsuba_generator(std::vector<uint32_t>::const_iterator abegin, std::vector<uint32_t>::const_iterator aend,
                              std::vector<uint32_t>::const_iterator bbegin, std::vector<uint32_t>::const_iterator bend);
-    // TODO 
-    // class iterator
-    //{
-    //
-    //}
-
-    // iterator::begin();
-    // iterator::end();
-  };
+
+    class iterator
+    {
+    public:
+      struct End_tag_t {};
+
+      // make an end iterator
+      iterator(const Prod_Karatsuba_generator& the_parent, End_tag_t);
+      explicit iterator(const Prod_Karatsuba_generator& the_parent);
+
+      bool operator==(const iterator& rhs) const noexcept;
+      bool operator!=(const iterator& rhs) const noexcept
+      {
+        return not (*this == rhs);
+      }
+
+      const uint32_t& operator*() const noexcept
+      {
+        return m_value;
+      }
+
+      //pre-increment
+      iterator& operator++();
+
+      // post increment
+      iterator operator++(int)
+      {
+        iterator tmp(*this);
+        operator++();
+        return tmp;
+      }
+
+      using difference_type = ptrdiff_t;
+      using value_type = uint32_t;
+      using pointer = const uint32_t*;
+      using reference = const uint32_t&;   // so read-only
+      using iterator_category = std::forward_iterator_tag;
+
+    private:
+      const uint32_t* block_of_a(const size_t i) const noexcept;
+      const uint32_t* block_of_b(const size_t j) const noexcept;
+      void sum_diagonal();   // add the block products of diagonal m_block to m_window
+      void set_value() noexcept;
+
+      const Prod_Karatsuba_generator* m_parent;
+      size_t m_block;                   // the diagonal k, words [k*B, (k+1)*B) are being returned
+      size_t m_index;                   // index of the current word in the product
+      std::vector<uint32_t> m_window;   // words [k*B, (k+2)*B+2) of the partial sum
+      std::vector<uint32_t> m_product;  // one block product
+      std::vector<uint32_t> m_scratch;  // for the Karatsuba multiply
+      std::vector<uint32_t> m_a_last;   // the last block of a, zero padded
+      std::vector<uint32_t> m_b_last;   // the last block of b, zero padded
+      uint32_t m_value;
+      bool m_done;
+    };  // end class iterator of Prod_Karatsuba_generator
+
+    iterator begin() const
+    {
+      return iterator(*this);
+    }
+
+    iterator end() const
+    {
+      return iterator(*this, iterator::End_tag_t());
+    }
+
+  private:
+    const uint32_t* m_a;
+    size_t m_asize;
+    const uint32_t* m_b;
+    size_t m_bsize;
+  };  // end class Prod_Karatsuba_generator
 
 
 
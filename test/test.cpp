@@ -9,11 +9,13 @@
 #include <chrono>
 #include <random>
 #include <algorithm>
+#include <memory>
 #include <iso646.h>   // so "not" 'or" and "and" work, VSC++ bug
 #include <windows.h>  // for Sleep
 
 using BNat = Big_numbers::Nat;
-//using BNat_mut = Big_numbers::Nat_mut;
+using BInt = Big_numbers::Int;
+using BNat_mut = Big_numbers::Nat_mut;
 using vec32 = std::vector<uint32_t>;
 
 static vec32 make_random_vnat_of_size(size_t maxsize, std::minstd_rand0& generator)
@@ -158,6 +160,18 @@ std::vector<uint32_t> mul_using_generator(
   return result;
 }
 
+// multiplies two vectors using the block Karatsuba product generator.
+std::vector<uint32_t> mul_using_Karatsuba_generator(const vec32& a, const vec32& b)
+{
+  std::vector<uint32_t> result;
+  Big_numbers::Prod_Karatsuba_generator gen(a.begin(), a.end(), b.begin(), b.end());
+  for (auto iter = gen.begin(); iter != gen.end(); ++iter)
+  {
+    result.push_back(*iter);
+  }
+  return result;
+}
+
 std::vector<uint32_t> mul_word_to_vector_using_generator(
   const std::vector <uint32_t>::const_iterator abegin,
   const std::vector<uint32_t>::const_iterator aend,
@@ -846,7 +860,6 @@ int main()
     }
   }
 
-#if 0
   {
     const std::string test_name("mutate by multiply");
     time_t start_time;
@@ -883,7 +896,6 @@ int main()
     seconds = difftime(end_time, start_time);
     std::cout << "elapsed seconds:" << seconds << std::endl;
   }
-#endif
 
   {
     const std::string test_name("multiply_fuzz_test");
@@ -944,118 +956,1244 @@ int main()
 
 
   {
-    const std::string test_name("div_multiply_fuzz_test");
-    std::cout << "running " << test_name.c_str() << std::endl;
+    const std::string test_name("square_fuzz_test");
+    // compare Nat::square to the old-fashioned multiply, and to a*a.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
 
-    // generate random number d!=0, random r<d, random q,  and compute
-    // n = q*d + r.
-    // Then verify that 
-    //   (q,r) = div(n,d)   (floor(n/d), n remainder d))
+    for (unsigned i(0); i < 100; ++i)
+    {
+      const BNat a(make_random_vnat_of_size(255u, generator));
+      const BNat a_copy(a);
 
-    bool success(true);
+      const vec32 result1 = Big_numbers::mul_old_fashioned(a.num.d, a_copy.num.d);
+      const BNat result2 = a.square();
+      const BNat result3 = a * a;
+
+      if ((result1 != result2.num.d) || (result2 != result3))
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i << " size=" << a.num_word32() << std::endl;
+        return -1;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
 
+
+  {
+    const std::string test_name("Karatsuba_generator_fuzz_test");
+    // compare the words from Prod_Karatsuba_generator to mul_vec32,
+    // for sizes that are within one block and that span many blocks.
+    bool success(true);
     std::minstd_rand0 generator(seed1);
-    const size_t sizem(0x7Fu);
 #ifdef _DEBUG
-    const size_t num_iters(20u);
+    const size_t max_size(3u * Big_numbers::PROD_GENERATOR_BLOCK_SIZE);
 #else
-    const size_t num_iters(1'000'000u);
+    const size_t max_size(12u * Big_numbers::PROD_GENERATOR_BLOCK_SIZE);
 #endif
-    size_t iter_percent(0);
-    myclock::time_point start2 = myclock::now();
-    for (size_t i(0); i < num_iters; ++i)
+
+    for (unsigned i(0); i < 40; ++i)
     {
-      size_t percent_done = (i * 100u) / num_iters;
-      if (percent_done > iter_percent)
+      vec32 a = make_random_vnat_of_size((i < 10u) ? 10u : max_size, generator);
+      vec32 b = make_random_vnat_of_size(max_size, generator);
+      if (i % 8u == 1u)
       {
-        iter_percent = percent_done;
-        if (0 == (iter_percent % 10))
-        {
-          std::cout << test_name.c_str() << " " << iter_percent << "% done" << std::endl;
-        }
+        std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        std::fill(b.begin(), b.end(), 0xffff'ffffu);
       }
 
-      BNat q(make_random_vnat_of_size(sizem, generator));  // 7 is a mask for sizes to allow, between 1 and 7 words in the vector
-      BNat d(make_random_nonzero_vnat_of_size(sizem, generator));
-      BNat r(make_random_nonzero_vnat_le(d.num.d, generator));
-      BNat n = (q*d) + r;
-
-      auto result = div(n, d);
-
-      if (result.second != r)
+      const vec32 result1 = Big_numbers::mul_vec32(a, b);
+      const vec32 result2 = mul_using_Karatsuba_generator(a, b);
+      const vec32 result3 = mul_using_Karatsuba_generator(a, a);
+      if ((result1 != result2) || (Big_numbers::mul_vec32(a, a) != result3))
       {
-        std::cout << "expected remainder=" << r << " actual remainder=" << result.second << std::endl;
         success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
         return -1;
       }
+    }
 
-      if (result.first != q)
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("div_by_word_divisor_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // n = q*d + r with r < d, for one word divisors with every shift, including
+    // 1, powers of 2 and all ones, must give (q, r) from div(n, Word_divisor(d))
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(2'000u);
+#else
+    const unsigned num_iters(200'000u);
+#endif
+    std::uniform_int_distribution<uint32_t> dist32(1u, 0xffff'ffffu);
+    std::uniform_int_distribution<unsigned> dist_shift(0u, 31u);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      uint32_t d = std::max(1u, dist32(generator) >> dist_shift(generator));
+      if (i % 8u == 1u)
+      {
+        d = 1u << dist_shift(generator);
+      }
+      else if (i % 8u == 2u)
+      {
+        d = 0xffff'ffffu;
+      }
+      const Big_numbers::Word_divisor divisor(d);
+      vec32 q = make_random_vnat_of_size(20u, generator);
+      if (i % 8u == 3u)
+      {
+        std::fill(q.begin(), q.end(), 0xffff'ffffu);
+      }
+      const uint32_t r = (i % 8u == 4u) ? d - 1u : dist32(generator) % d;
+      const BNat n(Big_numbers::add_vec32_and_word(Big_numbers::mul_vec32_by_word(q, d), r));
+
+      const std::pair<BNat, uint32_t> result = Big_numbers::div(n, divisor);
+      if ((result.first != BNat(q)) || (result.second != r))
       {
-        std::cout << "expected quotient=" << q << " actual quotient=" << result.first << std::endl;
         success = false;
-        return -1;
-        //break;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i << " d=" << d << std::endl;
+        break;
       }
-    } // forloop
+    }
 
     if (success)
     {
-      myclock::time_point end2 = myclock::now();
-      std::chrono::duration<double> time_span2 =
-        std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2);
-
       ++num_passed;
-      std::cout << "passed test " << test_name.c_str() << " with " << num_iters << " iterations, elapsed seconds=" << time_span2.count() << std::endl;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
     }
     else
     {
       ++num_failed;
       std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
     }
   }
 
 
+  {
+    const std::string test_name("mod_quot_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // mod and quot must give the two halves of div, for one word and longer divisors
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(500u);
+#else
+    const unsigned num_iters(50'000u);
+#endif
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const BNat n(make_random_vnat_of_size(200u, generator));
+      const BNat d(make_random_vnat_of_size((i % 4u == 0u) ? 1u : 100u, generator));
+      const std::pair<BNat, BNat> expected = Big_numbers::div(n, d);
+      bool ok = (Big_numbers::mod(n, d) == expected.second) && (Big_numbers::quot(n, d) == expected.first);
+
+      const uint32_t w = d.get_word(0);
+      const std::pair<BNat, uint32_t> expected_w = Big_numbers::div(n, w);
+      ok = ok && (Big_numbers::mod(n, w) == expected_w.second) && (Big_numbers::quot(n, w) == expected_w.first)
+        && (Big_numbers::mod(n, Big_numbers::Word_divisor(w)) == expected_w.second);
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << n.num_word32() << " " << d.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
 
 
   {
-    const std::string test_name("multiply_performance_fuzz_test");
+    const std::string test_name("divexact_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // divexact(a*d, d) must be a, for divisors with trailing zero bits and words,
+    // and sizes above BURNIKEL_ZIEGLER_THRESHOLD.
+    bool success(true);
     std::minstd_rand0 generator(seed1);
-    //generator.seed(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(500u);
+#else
+    const unsigned num_iters(20'000u);
+#endif
+    std::uniform_int_distribution<unsigned> dist_shift(0u, 31u);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 16u == 0u) ? 3u * Big_numbers::BURNIKEL_ZIEGLER_THRESHOLD : 40u;
+      const BNat a(make_random_vnat_of_size(max_size, generator));
+      vec32 dv = make_random_nonzero_vnat_of_size(max_size / 2u, generator);
+      if (i % 4u == 1u)
+      {
+        dv.insert(dv.begin(), i % 3u, 0u);
+        dv = Big_numbers::mul_vec32_by_word(dv, 1u << dist_shift(generator));
+      }
+      const BNat d(dv);
+      const BNat n = a * d;
+      bool ok = (Big_numbers::divexact(n, d) == a);
 
+      const uint32_t w = dv[0] | (1u << dist_shift(generator));
+      ok = ok && (Big_numbers::divexact(BNat(Big_numbers::mul_vec32_by_word(a.num.d, w)), w) == a);
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.num_word32() << " " << d.num_word32() << std::endl;
+        break;
+      }
+    }
 
-    // multiply psuedo-random numbers.
-    // compare fast-cache to convolution multiply for consistency.
-    // later do same test to compare times.
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("divisible_by_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // divisible_by must agree with mod, for multiples of d and for random numerators,
+    // and the batched version must agree with the one word version.
     bool success(true);
-    uint32_t parity(0);
+    std::minstd_rand0 generator(seed1);
 #ifdef _DEBUG
-    size_t max_size = 15u;
+    const unsigned num_iters(500u);
 #else
-    size_t max_size = 4096u;
+    const unsigned num_iters(20'000u);
 #endif
-    myclock::time_point start2 = myclock::now();
-    for (unsigned i(0); i < 100u; ++i)
+    std::uniform_int_distribution<uint32_t> dist32(0u, 0xffff'ffffu);
+    std::uniform_int_distribution<unsigned> dist_shift(0u, 31u);
+    std::vector<Big_numbers::Word_divisor> divisors;
+    for (uint32_t p : { 0u, 1u, 2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 37u, 41u, 43u, 47u })
     {
-      vec32 av = make_random_vnat_of_size(max_size, generator);
-      vec32 bv = make_random_vnat_of_size(max_size, generator);
+      divisors.push_back(Big_numbers::Word_divisor(p));
+    }
+    for (unsigned j(0); j < 100u; ++j)
+    {
+      divisors.push_back(Big_numbers::Word_divisor(dist32(generator) >> dist_shift(generator)));
+    }
+    std::unique_ptr<bool[]> results(new bool[divisors.size()]);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 16u == 0u) ? 3u * Big_numbers::BURNIKEL_ZIEGLER_THRESHOLD : 20u;
+      const BNat d(make_random_nonzero_vnat_of_size(max_size / 2u, generator));
+      const BNat a(make_random_vnat_of_size(max_size, generator));
+      const BNat n = (i % 2u == 0u) ? a * d : a;
+      bool ok = (Big_numbers::divisible_by(n, d) == Big_numbers::mod(n, d).is_zero());
+
+      const uint32_t w = std::max(1u, dist32(generator) >> dist_shift(generator));
+      const BNat nw = (i % 2u == 0u) ? BNat(Big_numbers::mul_vec32_by_word(n.num.d, w)) : n;
+      ok = ok && (Big_numbers::divisible_by(nw, w) == (Big_numbers::mod(nw, w) == 0u));
+
+      Big_numbers::divisible_by(nw, divisors.data(), divisors.size(), results.get());
+      for (size_t j(0); j < divisors.size(); ++j)
+      {
+        ok = ok && (results[j] == Big_numbers::divisible_by(nw, divisors[j].divisor()));
+      }
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << n.num_word32() << " " << d.num_word32() << std::endl;
+        break;
+      }
+    }
 
-      BNat a(std::move(av));
-      BNat b(std::move(bv));
-      BNat result(a * b);      // This allocates memory for the result.  Timing will reflect that
-      if (result.num_word32() != 0u)
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("montgomery_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // products and squares of Mont_nat must agree with mod of the Nat products,
+    // for odd moduli of one word up to sizes where the reduction is done with multiplies.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(300u);
+#else
+    const unsigned num_iters(10'000u);
+#endif
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 32u == 0u) ? 2u * Big_numbers::MONTGOMERY_REDC_N_THRESHOLD
+        : (i % 16u == 0u) ? 3u * Big_numbers::KARATSUBA_THRESHOLD : 20u;
+      vec32 mv = make_random_nonzero_vnat_of_size(max_size, generator);
+      mv[0] |= 1u;
+      const BNat m(mv);
+      const Big_numbers::Mod_context context(m);
+      const BNat a(make_random_vnat_of_size(2u * max_size, generator));
+      const BNat b(make_random_vnat_of_size(max_size, generator));
+      const Big_numbers::Mont_nat am(a, context);
+      const Big_numbers::Mont_nat bm(b, context);
+
+      bool ok = (am.to_nat() == Big_numbers::mod(a, m));
+      ok = ok && ((am * bm).to_nat() == Big_numbers::mod(a * b, m));
+      const BNat a_mod = Big_numbers::mod(a, m);
+      ok = ok && (am.square().to_nat() == Big_numbers::mod(a_mod * a_mod, m));
+      Big_numbers::Mont_nat c(am);
+      c *= bm;
+      c *= c;
+      const BNat ab_mod = Big_numbers::mod(a * b, m);
+      ok = ok && (c == Big_numbers::Mont_nat(ab_mod * ab_mod, context));
+      if (not ok)
       {
-        parity = parity ^ result.ls_word();
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " size=" << m.num_word32() << std::endl;
+        break;
       }
     }
 
-    myclock::time_point end2 = myclock::now();
-    std::chrono::duration<double> time_span2 =
-      std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2);
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
 
-    std::cout << "parity=" << std::hex << parity << std::dec;
-    std::cout << " elapsed seconds for multiply=" << time_span2.count() << std::endl;
-    ++num_passed;
-    std::cout << "passed test " << test_name.c_str() << std::endl;
+
+  {
+    const std::string test_name("barrett_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // mulmod with a Barrett_context must agree with mod of the product, for moduli
+    // that are even, odd or a power of 2**32, and operands larger than the modulus.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(300u);
+#else
+    const unsigned num_iters(10'000u);
+#endif
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 16u == 0u) ? 3u * Big_numbers::KARATSUBA_THRESHOLD : 20u;
+      vec32 mv = make_random_nonzero_vnat_of_size(max_size, generator);
+      if (i % 8u == 1u)
+      {
+        std::fill(mv.begin(), mv.end() - 1u, 0u);
+        mv.back() = 1u;
+      }
+      const BNat m(mv);
+      const Big_numbers::Barrett_context context(m);
+      const BNat a(make_random_vnat_of_size(2u * max_size, generator));
+      const BNat b(make_random_vnat_of_size(max_size, generator));
+
+      bool ok = (Big_numbers::mulmod(a, b, context) == Big_numbers::mod(a * b, m));
+      ok = ok && (Big_numbers::mulmod(a, b, m) == Big_numbers::mod(a * b, m));
+
+      // the square, on a range
+      const BNat a_mod = Big_numbers::mod(a, m);
+      vec32 x(a_mod.num.d);
+      x.resize(m.num_word32(), 0u);
+      Big_numbers::Workspace ws;
+      context.sqr(x.data(), x.data(), ws);
+      while ((x.size() != 0u) && (x.back() == 0u))
+      {
+        x.pop_back();
+      }
+      ok = ok && (BNat(x) == Big_numbers::mod(a_mod * a_mod, m));
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " size=" << m.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("pow_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // pow must agree with repeated multiplies, for bases with trailing zero bits and words.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(100u);
+#else
+    const unsigned num_iters(2'000u);
+#endif
+    std::uniform_int_distribution<unsigned> dist_exp(0u, 100u);
+    std::uniform_int_distribution<unsigned> dist_shift(0u, 31u);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      vec32 bv = make_random_vnat_of_size((i % 16u == 0u) ? 10u : 3u, generator);
+      if ((i % 4u == 1u) && (bv.size() != 0u))
+      {
+        bv.insert(bv.begin(), i % 3u, 0u);
+        bv = Big_numbers::mul_vec32_by_word(bv, 1u << dist_shift(generator));
+      }
+      const BNat base(bv);
+      const unsigned exp = dist_exp(generator);
+      vec32 expected{ 1u };
+      for (unsigned j(0); j < exp; ++j)
+      {
+        expected = Big_numbers::mul_vec32(expected, bv);
+      }
+      bool ok = (Big_numbers::pow(base, exp) == BNat(expected));
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " size=" << base.num_word32() << " exp=" << exp << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("powmod_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // powmod must agree with square and multiply done with mod, for odd and even moduli,
+    // exponents long enough for every window size, and a**(p-1) = 1 for the prime 2**61-1.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(100u);
+#else
+    const unsigned num_iters(2'000u);
+#endif
+    const auto powmod_simple = [](const BNat& base, const BNat& exp, const BNat& m)
+    {
+      vec32 result = Big_numbers::div_vec32(vec32{ 1u }, m.num.d).second;
+      for (size_t i(32u * exp.num_word32()); i != 0u; )
+      {
+        --i;
+        result = Big_numbers::div_vec32(Big_numbers::mul_vec32(result, result), m.num.d).second;
+        if (((exp.get_word(i / 32u) >> (i % 32u)) & 1u) != 0u)
+        {
+          result = Big_numbers::div_vec32(Big_numbers::mul_vec32(result, base.num.d), m.num.d).second;
+        }
+      }
+      return BNat(result);
+    };
+
+    const BNat p(vec32{ 0xffff'ffffu, 0x1fff'ffffu });
+    const BNat p_minus_1(vec32{ 0xffff'fffeu, 0x1fff'ffffu });
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 16u == 0u) ? 3u * Big_numbers::KARATSUBA_THRESHOLD : 12u;
+      const size_t max_exp_size = (i % 8u == 0u) ? 160u : 4u;
+      const BNat m(make_random_nonzero_vnat_of_size(max_size, generator));
+      const BNat base(make_random_vnat_of_size(2u * max_size, generator));
+      const BNat exp(make_random_vnat_of_size(max_exp_size, generator));
+
+      bool ok = (Big_numbers::powmod(base, exp, m) == powmod_simple(base, exp, m));
+      const BNat a(make_random_nonzero_vnat_of_size(1u, generator));
+      ok = ok && (Big_numbers::powmod(a, p_minus_1, p) == BNat(1u));
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << m.num_word32() << " " << exp.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("gcd_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // gcd must agree with Euclid's algorithm done with div_vec32, for numbers with a
+    // random common factor (with twos in it), of sizes for the binary, Lehmer and half gcds.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(200u);
+#else
+    const unsigned num_iters(5'000u);
+#endif
+    std::uniform_int_distribution<unsigned> dist_shift(0u, 31u);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 16u == 0u) ? 100u : (i % 2u == 0u) ? 10u : 3u;
+      vec32 g = make_random_nonzero_vnat_of_size(max_size / 2u + 1u, generator);
+      g.insert(g.begin(), i % 3u, 0u);
+      g = Big_numbers::mul_vec32_by_word(g, 1u << dist_shift(generator));
+      const vec32 av = Big_numbers::mul_vec32(g, make_random_vnat_of_size(max_size, generator));
+      const vec32 bv = Big_numbers::mul_vec32(g, make_random_vnat_of_size(max_size, generator));
+
+      vec32 x(av);
+      vec32 y(bv);
+      while (not y.empty())
+      {
+        vec32 r = Big_numbers::div_vec32(x, y).second;
+        x.swap(y);
+        y.swap(r);
+      }
+      const BNat a(av);
+      const BNat b(bv);
+      bool ok = (Big_numbers::gcd(a, b) == BNat(x)) && (Big_numbers::gcd(b, a) == BNat(x));
+
+      if (i % 128u == 0u)
+      {
+        // Sizes for the half gcd, where Euclid's algorithm is too slow: the gcd must
+        // be a multiple of the common factor that divides both, with coprime cofactors.
+        const size_t large_size = 3u * Big_numbers::GCD_HGCD_THRESHOLD;
+        const BNat common(make_random_nonzero_vnat_of_size(large_size / 4u, generator));
+        const BNat c = common * BNat(make_random_nonzero_vnat_of_size(large_size, generator));
+        const BNat d = common * BNat(make_random_nonzero_vnat_of_size(large_size, generator));
+        const BNat g = Big_numbers::gcd(c, d);
+        ok = ok && Big_numbers::mod(g, common).is_zero();
+        ok = ok && Big_numbers::mod(c, g).is_zero() && Big_numbers::mod(d, g).is_zero();
+        ok = ok && (Big_numbers::gcd(Big_numbers::quot(c, g), Big_numbers::quot(d, g)) == BNat(1u));
+      }
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.num_word32() << " " << b.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("gcdext_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // gcdext must give the gcd, with s*a + t*b = g and |s| <= b/g, |t| <= a/g,
+    // and invmod(a, m) an x < m with a*x = 1 modulo m exactly when gcd(a, m) = 1.
+    // One workspace is used for all of them, as it is meant to be.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(200u);
+#else
+    const unsigned num_iters(5'000u);
+#endif
+    Big_numbers::Gcd_workspace ws;
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 128u == 0u) ? 3u * Big_numbers::GCD_HGCD_THRESHOLD
+                            : (i % 16u == 0u) ? 100u : (i % 2u == 0u) ? 10u : 3u;
+      const vec32 g = make_random_nonzero_vnat_of_size((i % 4u == 0u) ? max_size / 4u + 1u : 1u, generator);
+      const BNat a(Big_numbers::mul_vec32(g, make_random_vnat_of_size(max_size, generator)));
+      const BNat b(Big_numbers::mul_vec32(g, make_random_vnat_of_size(max_size, generator)));
+
+      const Big_numbers::Gcdext_result r = Big_numbers::gcdext(a, b, ws);
+      const vec32& s = r.s.num.d;
+      const vec32& t = r.t.num.d;
+      bool ok = (r.g == Big_numbers::gcd(a, b, ws));
+      ok = ok && not (s.empty() and r.s.num.negative) && not (t.empty() and r.t.num.negative);
+      ok = ok && (r.s.num.negative != r.t.num.negative || s.empty() || t.empty());
+      // the sum of the positive products is g more than that of the negative ones
+      const vec32 sa = Big_numbers::mul_vec32(s, a.num.d);
+      const vec32 tb = Big_numbers::mul_vec32(t, b.num.d);
+      const vec32 positive = Big_numbers::add_vec32(r.s.num.negative ? vec32() : sa, r.t.num.negative ? vec32() : tb);
+      const vec32 negative = Big_numbers::add_vec32(r.s.num.negative ? sa : vec32(), r.t.num.negative ? tb : vec32());
+      ok = ok && (positive == Big_numbers::add_vec32(negative, r.g.num.d));
+      if (a.is_nonzero() && b.is_nonzero())
+      {
+        ok = ok && not Big_numbers::less_than(b.num.d, Big_numbers::mul_vec32(s, r.g.num.d));
+        ok = ok && not Big_numbers::less_than(a.num.d, Big_numbers::mul_vec32(t, r.g.num.d));
+      }
+
+      const BNat m(make_random_nonzero_vnat_of_size(std::max(max_size / 2u, size_t(1u)), generator));
+      const std::pair<bool, BNat> x = Big_numbers::invmod(a, m, ws);
+      if (Big_numbers::gcd(a, m, ws) == BNat(1u))
+      {
+        ok = ok && x.first && Big_numbers::less_than(x.second.num.d, m.num.d);
+        ok = ok && (Big_numbers::mod(Big_numbers::mul(a, x.second), m) == Big_numbers::mod(BNat(1u), m));
+      }
+      else
+      {
+        ok = ok && not x.first;
+      }
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.num_word32() << " " << b.num_word32() << " " << m.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("gcdext_hgcd_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // gcdext of a and b made from their continued fraction, mostly small quotients but now
+    // and then a large one, a 1 and another large one, so that hgcd of the leading words
+    // can swap them and then stop, and the reduction after it starts with a < b.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+    std::uniform_int_distribution<uint32_t> dist_kind(0u, 40u);
+    std::uniform_int_distribution<uint32_t> dist_small(1u, 1000u);
+#ifdef _DEBUG
+    const unsigned num_iters(4u);
+#else
+    const unsigned num_iters(20u);
+#endif
+    Big_numbers::Gcd_workspace ws;
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      // (a;b) = (q 1; 1 0) (a;b) for the quotients q from the last, starting from gcd 1
+      vec32 a(1u, 1u);
+      vec32 b;
+      const size_t size = 5u * Big_numbers::GCD_HGCD_THRESHOLD / 4u;
+      while (a.size() < size)
+      {
+        std::vector<vec32> q;
+        if (dist_kind(generator) == 0u)
+        {
+          q.push_back(make_random_nonzero_vnat_of_size(size / 8u, generator));
+          q.push_back(vec32(1u, 1u));
+          q.push_back(make_random_nonzero_vnat_of_size(size / 8u, generator));
+        }
+        else
+        {
+          q.push_back(vec32(1u, dist_small(generator)));
+        }
+        for (const vec32& qi : q)
+        {
+          vec32 c = Big_numbers::add_vec32(Big_numbers::mul_vec32(qi, a), b);
+          b.swap(a);
+          a.swap(c);
+        }
+      }
+
+      const BNat na(a);
+      const BNat nb(b);
+      const Big_numbers::Gcdext_result r = Big_numbers::gcdext(na, nb, ws);
+      const vec32 sa = Big_numbers::mul_vec32(r.s.num.d, a);
+      const vec32 tb = Big_numbers::mul_vec32(r.t.num.d, b);
+      const vec32 positive = Big_numbers::add_vec32(r.s.num.negative ? vec32() : sa, r.t.num.negative ? vec32() : tb);
+      const vec32 negative = Big_numbers::add_vec32(r.s.num.negative ? sa : vec32(), r.t.num.negative ? tb : vec32());
+      bool ok = (r.g == BNat(1u));
+      ok = ok && (positive == Big_numbers::add_vec32(negative, r.g.num.d));
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("int_arithmetic_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // +, -, * and both divisions of Int must agree with int64_t for one word numbers,
+    // and for large ones (a + b) - b = a, (a * b) / b = a, and n = q*d + r with |r| < |d|
+    // and r of the sign that the kind of division says.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(200u);
+#else
+    const unsigned num_iters(10'000u);
+#endif
+    const auto to_int = [](const int64_t x)
+    {
+      const uint64_t m = (x < 0) ? 0u - uint64_t(x) : uint64_t(x);
+      vec32 v = { uint32_t(m), uint32_t(m >> 32u) };
+      while (not v.empty() && (v.back() == 0u))
+      {
+        v.pop_back();
+      }
+      return BInt(std::move(v), x < 0);
+    };
+    std::uniform_int_distribution<int32_t> dist32(-0x7fff'ffff, 0x7fff'ffff);
+    std::uniform_int_distribution<unsigned> dist_sign(0u, 1u);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      // small ones, with some zeros and equal magnitudes
+      const int32_t x = (i % 8u == 0u) ? 0 : dist32(generator);
+      const int32_t y = (i % 8u == 1u) ? 0 : (i % 8u == 2u) ? -x : (i % 8u == 3u) ? x : dist32(generator);
+      const BInt a(x);
+      const BInt b(y);
+      bool ok = (a + b == to_int(int64_t(x) + y)) && (a - b == to_int(int64_t(x) - y));
+      ok = ok && (a * b == to_int(int64_t(x) * y)) && (-a == to_int(-int64_t(x)));
+      if (y != 0)
+      {
+        const int64_t q = int64_t(x) / y;
+        const int64_t r = int64_t(x) % y;
+        const bool down = (r != 0) && ((r < 0) != (y < 0));
+        ok = ok && (a / b == to_int(q)) && (a % b == to_int(r));
+        const std::pair<BInt, BInt> qr = Big_numbers::div_floor(a, b);
+        ok = ok && (qr.first == to_int(down ? q - 1 : q)) && (qr.second == to_int(down ? r + y : r));
+      }
+
+      // large ones
+      const vec32 cv = make_random_vnat_of_size(40u, generator);
+      const BInt c(cv, not cv.empty() && (dist_sign(generator) != 0u));
+      const BInt d(make_random_nonzero_vnat_of_size(20u, generator), dist_sign(generator) != 0u);
+      const BInt n = c * d + c;
+      ok = ok && ((c + d) - d == c) && ((c - d) + d == c) && ((c * d) / d == c);
+      for (unsigned floor(0); floor < 2u; ++floor)
+      {
+        const std::pair<BInt, BInt> qr = (floor != 0u) ? Big_numbers::div_floor(n, d) : Big_numbers::div(n, d);
+        const bool r_sign_ok = qr.second.is_zero() ||
+          (qr.second.num.negative == ((floor != 0u) ? d.num.negative : n.num.negative));
+        ok = ok && r_sign_ok && Big_numbers::less_than(qr.second.num.d, d.num.d) && (qr.first * d + qr.second == n);
+      }
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i << " x=" << x << " y=" << y << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("rvalue_operator_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // The operators on expiring operands must give what the ones on const operands give,
+    // with zeros, one word operands and b > a among them, and a sum that fits in the
+    // words of its expiring operand must be made in them.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(200u);
+#else
+    const unsigned num_iters(10'000u);
+#endif
+    std::uniform_int_distribution<unsigned> dist_sign(0u, 1u);
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t max_size = (i % 4u == 0u) ? 1u : 30u;
+      const BNat a(make_random_vnat_of_size(30u, generator));
+      const BNat b(make_random_vnat_of_size(max_size, generator));
+      bool ok = (BNat(a) + b == a + b) && (a + BNat(b) == a + b) && (BNat(a) + BNat(b) == a + b);
+      ok = ok && (BNat(a) - b == a - b) && (a - BNat(b) == a - b) && (BNat(a) - BNat(b) == a - b);
+      ok = ok && (BNat(b) - a == b - a) && (b - BNat(a) == b - a);
+      ok = ok && ((a < b) ? (a - b).is_zero() : (a - b) + b == a);
+      ok = ok && (BNat(a) * b == a * b) && (a * BNat(b) == a * b) && (BNat(a) * BNat(b) == a * b);
+      ok = ok && (BNat(a) / b == a / b) && (BNat(a) % b == a % b);
+      ok = ok && (a / b == Big_numbers::quot(a, b)) && (a % b == Big_numbers::mod(a, b));
+
+      const bool a_negative = a.is_nonzero() && (dist_sign(generator) != 0u);
+      const bool b_negative = b.is_nonzero() && (dist_sign(generator) != 0u);
+      const BInt x(a.num.d, a_negative);
+      const BInt y(b.num.d, b_negative);
+      ok = ok && (BInt(x) + y == x + y) && (x + BInt(y) == x + y) && (BInt(x) + BInt(y) == x + y);
+      ok = ok && (BInt(x) - y == x - y) && (x - BInt(y) == x - y) && (BInt(x) - BInt(y) == x - y);
+      ok = ok && (-BInt(x) == -x) && (BInt(y) - x == y - x) && (BInt(x) + BInt(-x)).is_zero();
+      ok = ok && (BInt(x) * y == x * y) && (x * BInt(y) == x * y) && (BInt(x) * BInt(y) == x * y);
+      ok = ok && (BInt(x) / y == x / y) && (BInt(x) % y == x % y);
+
+      // a + b + c with room in the first sum for the carry
+      vec32 words(a.num.d);
+      words.reserve(words.size() + 2u);
+      const uint32_t* const data = words.data();
+      const BNat sum = BNat(std::move(words)) + b + b;
+      ok = ok && (not (a.num_word32() > b.num_word32()) || (sum.num.d.data() == data)) && (sum == a + b + b);
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.num_word32() << " " << b.num_word32() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("nat_mut_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // A run of random compound assignments on a Nat_mut must follow the Nat operators,
+    // and its capacity must never shrink.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_iters(20u);
+#else
+    const unsigned num_iters(1'000u);
+#endif
+    std::uniform_int_distribution<unsigned> dist_op(0u, 15u);
+    std::uniform_int_distribution<uint32_t> dist32(0u, 0xffff'ffffu);
+    std::uniform_int_distribution<size_t> dist_bits(0u, 100u);
+    for (unsigned i(0); (i < num_iters) && success; ++i)
+    {
+      BNat_mut x(BNat(make_random_vnat_of_size(20u, generator)));
+      x.reserve(8u);
+      BNat expected = x.to_nat();
+      size_t capacity = x.capacity();
+      for (unsigned j(0); j < 50u; ++j)
+      {
+        // the operands keep the value from growing or shrinking much
+        const size_t size = std::max(expected.num_word32() / 2u, size_t(2u));
+        const BNat b((j % 8u == 7u) ? vec32() : make_random_vnat_of_size(size, generator));
+        const uint32_t w = (j % 8u == 6u) ? 0u : dist32(generator);
+        const size_t bits = dist_bits(generator);
+        const unsigned op = dist_op(generator);
+        switch (op)
+        {
+        case 0: x += b; expected = expected + b; break;
+        case 1: x += w; expected = expected + BNat(w); break;
+        case 2: x -= b; expected = expected - b; break;
+        case 3: x -= w; expected = expected - BNat(w); break;
+        case 4: x *= b; expected = expected * b; break;
+        case 5: x *= w; expected = expected * BNat(w); break;
+        case 6: x /= b; expected = expected / b; break;
+        case 7: x /= w; expected = expected / BNat(w); break;
+        case 8: x %= b; expected = expected % b; break;
+        case 9: x %= w; expected = expected % BNat(w); break;
+        case 10: x <<= bits; expected = Big_numbers::mul(expected, Big_numbers::pow(BNat(2u), bits)); break;
+        case 11: x >>= bits; expected = Big_numbers::quot(expected, Big_numbers::pow(BNat(2u), bits)); break;
+        case 12: x.increment_by(x); expected = expected + expected; break;
+        case 13: x.scale_by(x); expected = expected * expected; break;
+        case 14: x.scale_by(BNat_mut(b)); expected = expected * b; break;
+        default: x = BNat_mut(BNat(make_random_vnat_of_size(20u, generator))); expected = x.to_nat(); capacity = 0u; break;
+        }
+        if ((x != expected) || (x.capacity() < capacity))
+        {
+          success = false;
+          std::cout << "fail of " << test_name.c_str() << " index=" << i << "," << j << " op=" << op
+            << " sizes=" << x.num_word32() << " " << expected.num_word32() << std::endl;
+          break;
+        }
+        capacity = x.capacity();
+        if (expected.num_word32() > 200u)
+        {
+          x %= BNat(make_random_nonzero_vnat_of_size(50u, generator));
+          expected = x.to_nat();
+        }
+      }
+      const uint32_t* const data = x.num.d.data();
+      const BNat moved = std::move(x).to_nat();
+      success = success && (moved == expected) && (moved.num.d.empty() || (moved.num.d.data() == data));
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("div_reciprocal_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // div(n, Reciprocal(d)) must give the same quotient and remainder as div(n, d),
+    // for numerators from half of the size of d to more than twice its size.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned num_divisors(2u);
+#else
+    const unsigned num_divisors(8u);
+#endif
+    std::uniform_int_distribution<size_t> dist_size(Big_numbers::RECIPROCAL_THRESHOLD, 2u * Big_numbers::RECIPROCAL_THRESHOLD);
+    std::uniform_int_distribution<uint32_t> dist32(0u, 0xffff'ffffu);
+
+    for (unsigned i(0); (i < num_divisors) && success; ++i)
+    {
+      vec32 d(dist_size(generator));
+      for (uint32_t& w : d)
+      {
+        w = (i % 4u == 1u) ? 0xffff'ffffu : dist32(generator);
+      }
+      d.back() = (i % 4u == 2u) ? 1u : (d.back() | 1u);
+      const BNat divisor(d);
+      const Big_numbers::Reciprocal reciprocal(divisor);
+      for (unsigned j(0); j < 5u; ++j)
+      {
+        // the fourth one is all ones
+        vec32 n(((j + 1u) * d.size()) / 2u + j);
+        for (uint32_t& w : n)
+        {
+          w = (j == 3u) ? 0xffff'ffffu : dist32(generator);
+        }
+        n.back() |= 1u;
+        const BNat numerator(n);
+        const std::pair<BNat, BNat> expected = Big_numbers::div(numerator, divisor);
+        const std::pair<BNat, BNat> actual = Big_numbers::div(numerator, reciprocal);
+        if ((actual.first != expected.first) || (actual.second != expected.second))
+        {
+          success = false;
+          std::cout << "fail of " << test_name.c_str() << " index=" << i << "," << j
+            << " sizes=" << n.size() << " " << d.size() << std::endl;
+          break;
+        }
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+      return -1;
+    }
+  }
+
+
+  {
+    const std::string test_name("div_multiply_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+
+    // generate random number d!=0, random r<d, random q,  and compute
+    // n = q*d + r.
+    // Then verify that 
+    //   (q,r) = div(n,d)   (floor(n/d), n remainder d))
+
+    bool success(true);
+
+    std::minstd_rand0 generator(seed1);
+    const size_t sizem(0x7Fu);
+#ifdef _DEBUG
+    const size_t num_iters(20u);
+#else
+    const size_t num_iters(1'000'000u);
+#endif
+    size_t iter_percent(0);
+    myclock::time_point start2 = myclock::now();
+    for (size_t i(0); i < num_iters; ++i)
+    {
+      size_t percent_done = (i * 100u) / num_iters;
+      if (percent_done > iter_percent)
+      {
+        iter_percent = percent_done;
+        if (0 == (iter_percent % 10))
+        {
+          std::cout << test_name.c_str() << " " << iter_percent << "% done" << std::endl;
+        }
+      }
+
+      BNat q(make_random_vnat_of_size(sizem, generator));  // 7 is a mask for sizes to allow, between 1 and 7 words in the vector
+      BNat d(make_random_nonzero_vnat_of_size(sizem, generator));
+      BNat r(make_random_nonzero_vnat_le(d.num.d, generator));
+      BNat n = (q*d) + r;
+
+      auto result = div(n, d);
+
+      if (result.second != r)
+      {
+        std::cout << "expected remainder=" << r << " actual remainder=" << result.second << std::endl;
+        success = false;
+        return -1;
+      }
+
+      if (result.first != q)
+      {
+        std::cout << "expected quotient=" << q << " actual quotient=" << result.first << std::endl;
+        success = false;
+        return -1;
+        //break;
+      }
+    } // forloop
+
+    if (success)
+    {
+      myclock::time_point end2 = myclock::now();
+      std::chrono::duration<double> time_span2 =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2);
+
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << " with " << num_iters << " iterations, elapsed seconds=" << time_span2.count() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+
+
+  {
+    const std::string test_name("multiply_performance_fuzz_test");
+    std::minstd_rand0 generator(seed1);
+    //generator.seed(seed1);
+
+
+    // multiply psuedo-random numbers.
+    // compare fast-cache to convolution multiply for consistency.
+    // later do same test to compare times.
+    bool success(true);
+    uint32_t parity(0);
+#ifdef _DEBUG
+    size_t max_size = 15u;
+#else
+    size_t max_size = 4096u;
+#endif
+    myclock::time_point start2 = myclock::now();
+    for (unsigned i(0); i < 100u; ++i)
+    {
+      vec32 av = make_random_vnat_of_size(max_size, generator);
+      vec32 bv = make_random_vnat_of_size(max_size, generator);
+
+      BNat a(std::move(av));
+      BNat b(std::move(bv));
+      BNat result(a * b);      // This allocates memory for the result.  Timing will reflect that
+      if (result.num_word32() != 0u)
+      {
+        parity = parity ^ result.ls_word();
+      }
+    }
+
+    myclock::time_point end2 = myclock::now();
+    std::chrono::duration<double> time_span2 =
+      std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2);
+
+    std::cout << "parity=" << std::hex << parity << std::dec;
+    std::cout << " elapsed seconds for multiply=" << time_span2.count() << std::endl;
+    ++num_passed;
+    std::cout << "passed test " << test_name.c_str() << std::endl;
+  }
+
+
+  {
+    const std::string test_name("chained_expression_performance_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // Moving a Nat or an Int, or making one from a vec32 rvalue, must take the words
+    // instead of copying them.  Then a chained expression costs the same as its vec32
+    // operations, which allocate only their results.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+    vec32 words = make_random_nonzero_vnat_of_size(100u, generator);
+    const uint32_t* const data = words.data();
+    BNat moved(std::move(words));
+    success = success && (moved.num.d.data() == data);
+    BNat assigned;
+    assigned = std::move(moved);
+    success = success && (assigned.num.d.data() == data);
+    BInt signed_moved(std::move(assigned));
+    success = success && (signed_moved.num.d.data() == data);
+    BInt signed_assigned;
+    signed_assigned = std::move(signed_moved);
+    success = success && (signed_assigned.num.d.data() == data);
+
+#ifdef _DEBUG
+    const unsigned num_iters(100u);
+    const size_t size = 15u;
+#else
+    const unsigned num_iters(100'000u);
+    const size_t size = 20u;
+#endif
+    const vec32 av = make_random_nonzero_vnat_of_size(size, generator);
+    const vec32 bv = make_random_nonzero_vnat_of_size(size, generator);
+    const vec32 cv = make_random_nonzero_vnat_of_size(size, generator);
+    const vec32 dv = make_random_nonzero_vnat_of_size(size, generator);
+    const BNat a(av);
+    const BNat b(bv);
+    const BNat c(cv);
+    const BNat d(dv);
+    const BInt x(av, true);
+    const BInt y(bv, false);
+    uint32_t parity(0);
+
+    myclock::time_point start = myclock::now();
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const vec32 r = Big_numbers::add_vec32(Big_numbers::mul_vec32(Big_numbers::add_vec32(av, bv), cv), dv);
+      parity += r[0];
+    }
+    const double vec32_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(myclock::now() - start).count();
+
+    start = myclock::now();
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const BNat r = (a + b) * c + d;
+      parity += r.ls_word();
+    }
+    const double nat_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(myclock::now() - start).count();
+
+    start = myclock::now();
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const BInt r = (x - y) * x + y;
+      parity += r.ls_word();
+    }
+    const double int_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(myclock::now() - start).count();
+
+    std::cout << "parity=" << std::hex << parity << std::dec << " elapsed seconds for (a + b) * c + d: vec32="
+      << vec32_seconds << " Nat=" << nat_seconds << " Int (a - b) * a + b=" << int_seconds << std::endl;
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << ", a move copied the words" << std::endl;
+      return -1;
+    }
   }
 
 
@@ -250,7 +250,13 @@ int main()
     vec32 vw2 = { 0x33u };
     vec32 expected = { 0x31u, 0x1u };  // the 1u is the carry into MSB
     vec32 sum = Big_numbers::add_vec32(vw1, vw2);
-    if (sum == expected)
+
+    // a carry into two maxvalue words has to carry out again
+    vec32 vw3 = { 0xFFFF'FFFFu, 0xFFFF'FFFFu, 0x1u };
+    vec32 vw4 = { 0xFFFF'FFFFu, 0xFFFF'FFFFu };
+    vec32 expected2 = { 0xFFFF'FFFEu, 0xFFFF'FFFFu, 0x2u };
+    vec32 sum2 = Big_numbers::add_vec32(vw3, vw4);
+    if ((sum == expected) && (sum2 == expected2))
     {
       ++num_passed;
       std::cout << "passed test " << test_name.c_str() << std::endl;
@@ -314,6 +320,22 @@ int main()
         }
       }
     }
+    if (success)
+    {
+      // the difference has to be normalized, no zero MSW
+      vec32 v5 = { 0x0u, 0x5u };
+      vec32 v6 = { 0x1u, 0x4u };
+      vec32 expected_value5 = { 0xFFFF'FFFFu };
+      auto result5 = Big_numbers::symdiff_vec32(v5, v6);
+      auto result6 = Big_numbers::symdiff_vec32(v6, v5);
+      success = (result5.first == expected_value5) && result5.second
+        && (result6.first == expected_value5) && (not result6.second);
+      if (not success)
+      {
+        ++num_failed;
+        std::cout << "failed test " << test_name.c_str() << " part 5" << std::endl;
+      }
+    }
     if(success)
     {
       ++num_passed;
@@ -65,6 +65,24 @@ static vec32 make_random_nonzero_vnat_of_size(size_t maxsize, std::minstd_rand0&
   return rnat;
 }
 
+// make a random number with exactly size words (MSW nonzero)
+static vec32 make_random_vnat_of_exact_size(size_t size, std::minstd_rand0& generator)
+{
+  vec32 rnat;
+  std::uniform_int_distribution<uint32_t> dist32(0, 0xffff'ffffu);
+  std::uniform_int_distribution<uint32_t> dist1(1u, 0xffff'ffffu);
+  rnat.reserve(size);
+  for (size_t i(0); i < size; ++i)
+  {
+    rnat.push_back(dist32(generator));
+  }
+  if (size != 0u)
+  {
+    rnat.back() = dist1(generator);
+  }
+  return rnat;
+}
+
 // precondition v.size() != 0
 static vec32 make_random_nonzero_vnat_le(const vec32& v, std::minstd_rand0& generator)
 {
@@ -287,6 +305,436 @@ int main()
 
 
 
+  {
+    const std::string test_name("mul_Karatsuba_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare mul_vec32 (which uses Karatsuba above the threshold)
+    // to the convolution multiply, for balanced and unbalanced sizes.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(50u);
+#else
+    const unsigned int num_iters(1'000u);
+#endif
+    std::uniform_int_distribution<size_t> dist_size(1u, 8u * Big_numbers::KARATSUBA_THRESHOLD);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t bsize = dist_size(generator);
+      std::uniform_int_distribution<size_t> dist_asize((bsize + 1u) / 2u, bsize);
+      const vec32 a = make_random_vnat_of_exact_size(dist_asize(generator), generator);
+      vec32 b = make_random_vnat_of_exact_size(bsize, generator);
+      if (i % 4u == 0u)
+      {
+        // all ones, to force long carry chains
+        std::fill(b.begin(), b.end(), 0xffff'ffffu);
+      }
+
+      const vec32 result1 = Big_numbers::mul_conv(a, b);
+      const vec32 result2 = Big_numbers::mul_vec32(a, b);
+      const vec32 result3 = Big_numbers::mul_vec32(b, a);
+
+      vec32 result4(a.size() + b.size(), 0u);
+      const bool ok = Big_numbers::mul_Karatsuba(a.cbegin(), a.cend(), b.cbegin(), b.cend(), result4.begin());
+      while ((result4.size() != 0) && (result4.back() == 0))
+      {
+        result4.pop_back();
+      }
+
+      if ((result1 != result2) || (result1 != result3) || (not ok) || (result1 != result4))
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+        std::cout << "\nmul_conv result= " << result1 << std::endl;
+        std::cout << "\nmul_vec32 result= " << result2 << std::endl;
+        return -1;
+      }
+    }
+
+    // the precondition of mul_Karatsuba is checked
+    const vec32 small(3u, 1u);
+    const vec32 large(7u, 1u);
+    vec32 out(10u, 0u);
+    if (Big_numbers::mul_Karatsuba(small.cbegin(), small.cend(), large.cbegin(), large.cend(), out.begin()))
+    {
+      success = false;
+      std::cout << "fail of " << test_name.c_str() << " mul_Karatsuba accepted operands of sizes 3 and 7" << std::endl;
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("mul_Toom_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare mul_vec32 to the convolution multiply for sizes where
+    // the Toom-3 and Toom-4 multiplies are used.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(4u);
+#else
+    const unsigned int num_iters(40u);
+#endif
+    std::uniform_int_distribution<size_t> dist_size(Big_numbers::TOOM3_THRESHOLD, 3u * Big_numbers::TOOM4_THRESHOLD);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t bsize = dist_size(generator);
+      std::uniform_int_distribution<size_t> dist_asize((2u * bsize + 2u) / 3u, bsize);
+      vec32 a = make_random_vnat_of_exact_size(dist_asize(generator), generator);
+      vec32 b = make_random_vnat_of_exact_size(bsize, generator);
+      if (i % 4u == 0u)
+      {
+        // all ones, to force long carry chains in the evaluation and interpolation
+        std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        std::fill(b.begin(), b.end(), 0xffff'ffffu);
+      }
+
+      const vec32 result1 = Big_numbers::mul_conv(a, b);
+      const vec32 result2 = Big_numbers::mul_vec32(a, b);
+      if (result1 != result2)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+        return -1;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("mul_unbalanced_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare mul_vec32 to the convolution multiply when one operand is much
+    // longer than the other, so the blocked unbalanced multiply is used.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(10u);
+#else
+    const unsigned int num_iters(100u);
+#endif
+    std::uniform_int_distribution<size_t> dist_asize(Big_numbers::KARATSUBA_THRESHOLD + 1u, 4u * Big_numbers::TOOM3_THRESHOLD);
+    std::uniform_int_distribution<size_t> dist_ratio(2u, 20u);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t asize = dist_asize(generator);
+      std::uniform_int_distribution<size_t> dist_extra(1u, asize);
+      const size_t bsize = dist_ratio(generator) * asize + dist_extra(generator);  // leaves a short last chunk
+      vec32 a = make_random_vnat_of_exact_size(asize, generator);
+      vec32 b = make_random_vnat_of_exact_size(bsize, generator);
+      if (i % 4u == 0u)
+      {
+        std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        std::fill(b.begin(), b.end(), 0xffff'ffffu);
+      }
+
+      const vec32 result1 = Big_numbers::mul_conv(a, b);
+      if ((result1 != Big_numbers::mul_vec32(a, b)) || (result1 != Big_numbers::mul_vec32(b, a)))
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("mul_NTT_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare mul_vec32 to the convolution multiply for sizes where the
+    // number-theoretic transform multiply is used, and check the square of
+    // 2**(32n)-1, which is 2**(64n) - 2**(32n+1) + 1, for a large n.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(1u);
+    const size_t ones_size(Big_numbers::NTT_THRESHOLD);
+#else
+    const unsigned int num_iters(6u);
+    const size_t ones_size(1'000'000u);
+#endif
+    std::uniform_int_distribution<size_t> dist_size(Big_numbers::NTT_THRESHOLD, 2u * Big_numbers::NTT_THRESHOLD);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const size_t bsize = dist_size(generator);
+      std::uniform_int_distribution<size_t> dist_asize(std::max(Big_numbers::NTT_THRESHOLD, bsize / 2u), bsize);
+      vec32 a = make_random_vnat_of_exact_size(dist_asize(generator), generator);
+      vec32 b = make_random_vnat_of_exact_size(bsize, generator);
+      if (i % 3u == 1u)
+      {
+        // all ones gives the largest convolution coefficients
+        std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        std::fill(b.begin(), b.end(), 0xffff'ffffu);
+      }
+
+      const vec32 result1 = Big_numbers::mul_conv(a, b);
+      const vec32 result2 = Big_numbers::mul_vec32(a, b);
+      if (result1 != result2)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+      }
+    }
+
+    const vec32 ones(ones_size, 0xffff'ffffu);
+    vec32 expected(2u * ones_size, 0xffff'ffffu);
+    std::fill(expected.begin(), expected.begin() + ones_size, 0u);
+    expected[0] = 1u;
+    expected[ones_size] = 0xffff'fffeu;
+    if (Big_numbers::mul_vec32(ones, ones) != expected)
+    {
+      success = false;
+      std::cout << "fail of " << test_name.c_str() << " all ones size=" << ones_size << std::endl;
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("sqr_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare sqr_vec32, and mul_vec32 with both arguments the same object,
+    // to the convolution multiply, for sizes covering each squaring algorithm.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const std::array<size_t, 5> max_sizes = { 3u, 100u, 800u, 2500u, 2500u };
+#else
+    const std::array<size_t, 6> max_sizes = { 3u, 100u, 800u, 2500u, 8000u, 2u * Big_numbers::NTT_THRESHOLD };
+#endif
+
+    for (size_t k(0); k < max_sizes.size(); ++k)
+    {
+      std::uniform_int_distribution<size_t> dist_size(max_sizes[k] / 2u, max_sizes[k]);
+      for (unsigned i(0); i < 4u; ++i)
+      {
+        vec32 a = make_random_vnat_of_exact_size(dist_size(generator), generator);
+        if (i == 1u)
+        {
+          std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        }
+
+        const vec32 result1 = Big_numbers::mul_conv(a, a);
+        const vec32 result2 = Big_numbers::sqr_vec32(a);
+        const vec32 result3 = Big_numbers::mul_vec32(a, a);
+        if ((result1 != result2) || (result1 != result3))
+        {
+          success = false;
+          std::cout << "fail of " << test_name.c_str() << " size=" << a.size() << std::endl;
+        }
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("workspace_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // the versions of add, mul, sqr and div that write to caller provided ranges
+    // must agree with the vec32 versions, and must not grow a workspace that was
+    // sized with the *_scratch_size() functions.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(200u);
+#else
+    const unsigned int num_iters(5'000u);
+#endif
+    const size_t max_size(Big_numbers::TOOM3_THRESHOLD - 1u);
+    const size_t scratch_size = std::max(std::max(Big_numbers::mul_scratch_size(max_size, max_size),
+                                                  Big_numbers::sqr_scratch_size(max_size)),
+                                         Big_numbers::div_scratch_size(2u * max_size, max_size));
+    Big_numbers::Workspace ws(scratch_size);
+    std::uniform_int_distribution<size_t> dist_size(0u, max_size);
+    vec32 r(4u * max_size + 1u);
+    vec32 q(2u * max_size + 1u);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const vec32 a = make_random_vnat_of_exact_size(dist_size(generator), generator);
+      const vec32 b = make_random_vnat_of_exact_size(dist_size(generator), generator);
+
+      size_t size = Big_numbers::add_vec32(r.data(), a.data(), a.size(), b.data(), b.size());
+      bool ok = (vec32(r.begin(), r.begin() + size) == Big_numbers::add_vec32(a, b));
+
+      size = Big_numbers::mul_vec32(r.data(), a.data(), a.size(), b.data(), b.size(), ws);
+      ok = ok && (vec32(r.begin(), r.begin() + size) == Big_numbers::mul_conv(a, b));
+
+      size = Big_numbers::sqr_vec32(r.data(), a.data(), a.size(), ws);
+      ok = ok && (vec32(r.begin(), r.begin() + size) == Big_numbers::mul_conv(a, a));
+
+      if (b.size() != 0u)
+      {
+        // n = a*b + c, with c < b, so the quotient is a and the remainder c
+        const vec32 c = make_random_vnat_of_exact_size(b.size() - 1u, generator);
+        const vec32 n = Big_numbers::add_vec32(Big_numbers::mul_vec32(a, b), c);
+        const std::pair<size_t, size_t> sizes = Big_numbers::div_vec32(q.data(), r.data(), n.data(), n.size(), b.data(), b.size(), ws);
+        ok = ok && (vec32(q.begin(), q.begin() + sizes.first) == a) && (vec32(r.begin(), r.begin() + sizes.second) == c);
+      }
+
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " fuzz index=" << i
+          << " sizes=" << a.size() << " " << b.size() << std::endl;
+        break;
+      }
+    }
+
+    if (ws.size() != scratch_size)
+    {
+      success = false;
+      std::cout << "fail of " << test_name.c_str() << " workspace grew from " << scratch_size << " to " << ws.size() << std::endl;
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("mul_Karatsuba_crossover_performance_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // time the convolution multiply against mul_vec32 for balanced operands,
+    // to show where Karatsuba starts to win.  Each size is repeated to get
+    // about the same amount of work per line.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const std::array<size_t, 6> sizes = { 40u, 60u, 80u, 120u, 200u, 1'000u };
+#else
+    const std::array<size_t, 13> sizes = { 40u, 60u, 80u, 120u, 160u, 200u, 300u, 500u, 1'000u, 5'000u, 10'000u, 30'000u, 100'000u };
+#endif
+    size_t crossover(0u);
+    for (const size_t size : sizes)
+    {
+      const vec32 a = make_random_vnat_of_exact_size(size, generator);
+      const vec32 b = make_random_vnat_of_exact_size(size, generator);
+      const size_t reps = std::max(size_t(1u), size_t(40'000'000u) / (size * size));
+
+      vec32 result1;
+      myclock::time_point start1 = myclock::now();
+      for (size_t r(0); r < reps; ++r)
+      {
+        result1 = Big_numbers::mul_conv(a, b);
+      }
+      myclock::time_point end1 = myclock::now();
+
+      vec32 result2;
+      myclock::time_point start2 = myclock::now();
+      for (size_t r(0); r < reps; ++r)
+      {
+        result2 = Big_numbers::mul_vec32(a, b);
+      }
+      myclock::time_point end2 = myclock::now();
+
+      const double conv_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end1 - start1).count() / reps;
+      const double mul_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2).count() / reps;
+      // the crossover is the smallest size from which mul_vec32 stays faster
+      if (mul_seconds >= conv_seconds)
+      {
+        crossover = 0u;
+      }
+      else if (crossover == 0u)
+      {
+        crossover = size;
+      }
+      std::cout << test_name.c_str() << " size=" << std::dec << size
+        << " mul_conv seconds=" << conv_seconds
+        << " mul_vec32 seconds=" << mul_seconds
+        << " ratio=" << (conv_seconds / mul_seconds) << std::endl;
+      if (result1 != result2)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " results differ for size=" << size << std::endl;
+      }
+    }
+    std::cout << test_name.c_str() << " mul_vec32 faster from size=" << crossover
+      << " (KARATSUBA_THRESHOLD=" << Big_numbers::KARATSUBA_THRESHOLD << ")" << std::endl;
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
   {
     const std::string test_name("div_multiply_fuzz_test");
     std::cout << "running " << test_name.c_str() << std::endl;
@@ -360,6 +808,242 @@ int main()
 
 
 
+  {
+    const std::string test_name("div_differential_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // compare div_vec32 against the old long division div_old_fashioned,
+    // with divisors picked to hit the corner cases of Algorithm D:
+    // top word 0x80000000 (already normalized), all ones, a small top word
+    // (shift by 31 bits), and zero words inside the divisor.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(200u);
+#else
+    const unsigned int num_iters(50'000u);
+#endif
+    const size_t max_size(60u);
+    std::uniform_int_distribution<size_t> dist_size(1u, max_size);
+    std::uniform_int_distribution<unsigned> dist_kind(0u, 4u);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      vec32 d = make_random_vnat_of_exact_size(dist_size(generator), generator);
+      switch (dist_kind(generator))
+      {
+      case 0u:
+        d.back() = 0x8000'0000u;
+        break;
+      case 1u:
+        std::fill(d.begin(), d.end(), 0xffff'ffffu);
+        break;
+      case 2u:
+        d.back() = 1u;
+        break;
+      case 3u:
+        std::fill(d.begin(), d.end() - 1, 0u);
+        break;
+      default:
+        break;
+      }
+      vec32 n = make_random_vnat_of_exact_size(d.size() + dist_size(generator), generator);
+      if (i % 3u == 0u)
+      {
+        // numerator with all ones words, so quotient words estimate to 0xffffffff
+        std::fill(n.begin(), n.end(), 0xffff'ffffu);
+      }
+
+      const auto expected = Big_numbers::div_old_fashioned(n, d);
+      const auto actual = Big_numbers::div_vec32(n, d);
+      if ((actual.first != expected.first) or (actual.second != expected.second))
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " n=" << n << " d=" << d << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+
+  {
+    const std::string test_name("divrem_inplace_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // the in-place divisions must match div_vec32, reusing one workspace and quotient
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(200u);
+#else
+    const unsigned int num_iters(20'000u);
+#endif
+    std::uniform_int_distribution<size_t> dist_size(0u, 150u);
+    Big_numbers::Workspace ws;
+    vec32 q;
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      const vec32 n = make_random_vnat_of_exact_size(dist_size(generator), generator);
+      const vec32 d = make_random_vnat_of_exact_size(dist_size(generator) / 2u, generator);
+      const std::pair<vec32, vec32> expected = Big_numbers::div_vec32(n, d);
+
+      vec32 r(n);
+      Big_numbers::divrem_inplace(r, d, q, ws);
+      bool ok = (q == expected.first) && (r == expected.second);
+
+      const uint32_t w = (d.size() != 0u) ? d[0] : 0u;
+      const std::pair<vec32, vec32> expected_w = Big_numbers::div_vec32(n, (w != 0u) ? vec32(1u, w) : vec32());
+      vec32 qw(n);
+      const uint32_t rw = Big_numbers::divrem_inplace(qw, w);
+      ok = ok && (qw == expected_w.first) && (vec32((rw != 0u) ? 1u : 0u, rw) == expected_w.second);
+      if (not ok)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << n.size() << " " << d.size() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("div_Burnikel_Ziegler_fuzz_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // n = a*d + c with c < d, for divisors and quotients above BURNIKEL_ZIEGLER_THRESHOLD,
+    // so div_vec32 must return (a, c).  Includes all ones operands and c = d-1,
+    // which need the most corrections.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const unsigned int num_iters(20u);
+#else
+    const unsigned int num_iters(2'000u);
+#endif
+    const size_t min_size(Big_numbers::BURNIKEL_ZIEGLER_THRESHOLD);
+    std::uniform_int_distribution<size_t> dist_size(min_size, 20u * min_size);
+
+    for (unsigned i(0); i < num_iters; ++i)
+    {
+      vec32 d = make_random_vnat_of_exact_size(dist_size(generator), generator);
+      vec32 a = make_random_vnat_of_exact_size(dist_size(generator), generator);
+      vec32 c = make_random_vnat_of_exact_size(d.size() - 1u, generator);
+      switch (i % 4u)
+      {
+      case 1u:
+        std::fill(a.begin(), a.end(), 0xffff'ffffu);
+        break;
+      case 2u:
+        std::fill(d.begin(), d.end(), 0xffff'ffffu);
+        c = d;
+        c[0] -= 1u;
+        break;
+      case 3u:
+        d.back() = 1u;
+        break;
+      default:
+        break;
+      }
+      const vec32 n = Big_numbers::add_vec32(Big_numbers::mul_vec32(a, d), c);
+      const auto result = Big_numbers::div_vec32(n, d);
+      if ((result.first != a) or (result.second != c))
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " index=" << i
+          << " sizes=" << a.size() << " " << d.size() << std::endl;
+        break;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+  {
+    const std::string test_name("div_performance_test");
+    std::cout << "running " << test_name.c_str() << std::endl;
+    // time dividing a 2n word number by an n word number against multiplying
+    // two n word numbers.  With the Burnikel-Ziegler division the ratio grows
+    // slowly (about log n) instead of linearly.
+    bool success(true);
+    std::minstd_rand0 generator(seed1);
+#ifdef _DEBUG
+    const std::array<size_t, 3> sizes = { 100u, 1'000u, 3'000u };
+#else
+    const std::array<size_t, 5> sizes = { 100u, 1'000u, 10'000u, 100'000u, 1'000'000u };
+#endif
+    for (const size_t size : sizes)
+    {
+      const vec32 d = make_random_vnat_of_exact_size(size, generator);
+      const vec32 n = make_random_vnat_of_exact_size(2u * size, generator);
+
+      myclock::time_point start1 = myclock::now();
+      const vec32 product = Big_numbers::mul_vec32(d, d);
+      myclock::time_point end1 = myclock::now();
+
+      myclock::time_point start2 = myclock::now();
+      const auto result = Big_numbers::div_vec32(n, d);
+      myclock::time_point end2 = myclock::now();
+
+      const double mul_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end1 - start1).count();
+      const double div_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end2 - start2).count();
+      std::cout << test_name.c_str() << " size=" << std::dec << size
+        << " mul_vec32 seconds=" << mul_seconds
+        << " div_vec32 seconds=" << div_seconds
+        << " ratio=" << (div_seconds / mul_seconds) << std::endl;
+      if (Big_numbers::add_vec32(Big_numbers::mul_vec32(result.first, d), result.second) != n)
+      {
+        success = false;
+        std::cout << "fail of " << test_name.c_str() << " n != q*d + r for size=" << size << std::endl;
+      }
+    }
+
+    if (success)
+    {
+      ++num_passed;
+      std::cout << "passed test " << test_name.c_str() << std::endl;
+    }
+    else
+    {
+      ++num_failed;
+      std::cout << "failed test " << test_name.c_str() << std::endl;
+    }
+  }
+
+
+
 
 
   std::cout << "passed " << num_passed << " tests" << std::endl;